@@ -0,0 +1,1103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+const uint32_t LIMB_BASE = 1000000000; // основание разрядов длинных чисел
+const int LIMB_DIGITS = 9; // количество десятичных цифр в одном разряде
+
+// длинное целое число со знаком, разряды по основанию 10^9 хранятся начиная с младшего
+class BigInteger {
+	vector<uint32_t> limbs; // разряды модуля числа
+	bool negative; // отрицательно ли число
+
+	void Trim(); // удаление ведущих нулевых разрядов
+
+	static int CompareMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b); // сравнение модулей
+	static vector<uint32_t> AddMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b); // сложение модулей
+	static vector<uint32_t> SubtractMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b); // вычитание модулей (a >= b)
+
+public:
+	BigInteger(long long value = 0); // конструктор из обычного целого числа
+
+	static BigInteger FromDigits(const string& digits); // создание из строки десятичных цифр
+	static BigInteger Power10(long long exponent); // степень десяти
+	static void ParseDecimal(const string& s, string& digits, long long& exponent); // разбор десятичной записи на цифры и десятичный порядок
+	static void DivideLimbs(const uint32_t *u, size_t m, const uint32_t *v, size_t n, uint32_t *q, uint32_t *r, uint32_t *work); // деление модулей из разрядов
+	static void DivMod(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder); // деление с остатком (с отбрасыванием дробной части)
+	static BigInteger Gcd(BigInteger a, BigInteger b); // наибольший общий делитель
+
+	bool IsZero() const; // проверка на ноль
+	bool IsNegative() const; // проверка на отрицательность
+	int Compare(const BigInteger& b) const; // сравнение с числом
+	long long ToInteger() const; // перевод в обычное целое число
+	double Length() const; // десятичный логарифм модуля по старшему разряду, оценка количества цифр
+
+	BigInteger operator-() const;
+	BigInteger operator+(const BigInteger& b) const;
+	BigInteger operator-(const BigInteger& b) const;
+	BigInteger operator*(const BigInteger& b) const;
+	BigInteger operator/(const BigInteger& b) const;
+	BigInteger operator%(const BigInteger& b) const;
+
+	bool operator==(const BigInteger& b) const;
+	bool operator<(const BigInteger& b) const;
+
+	string ToString() const; // перевод в строку
+};
+
+// точная рациональная дробь, знаменатель всегда положителен и взаимно прост с числителем
+class Rational {
+	BigInteger numerator; // числитель
+	BigInteger denominator; // знаменатель
+
+	void Normalize(); // сокращение дроби
+
+public:
+	Rational(long long value = 0); // конструктор из целого числа
+	Rational(const BigInteger& numerator, const BigInteger& denominator); // конструктор из числителя и знаменателя
+
+	static Rational FromString(const string& s); // создание из десятичной записи
+
+	bool IsInteger() const; // проверка на целое число
+	int Sign() const; // знак дроби
+	BigInteger Trunc() const; // целая часть с отбрасыванием дробной
+	long long ToInteger() const; // целая часть в виде обычного целого числа
+	double Length() const; // оценка количества цифр наибольшего из числителя и знаменателя
+	Rational Power(long long exponent) const; // возведение в целую степень
+
+	Rational operator-() const;
+	Rational operator+(const Rational& b) const;
+	Rational operator-(const Rational& b) const;
+	Rational operator*(const Rational& b) const;
+	Rational operator/(const Rational& b) const;
+
+	bool operator==(const Rational& b) const;
+	bool operator<(const Rational& b) const;
+	bool operator>(const Rational& b) const;
+
+	string ToString() const; // перевод в строку вида p/q
+};
+
+// десятичное число с плавающей точкой фиксированной длины: мантисса из LIMBS разрядов по основанию 10^9 хранится
+// внутри самого числа, поэтому арифметика не выделяет память; значение = мантисса * (10^9)^exponent
+class BigFloat {
+public:
+	static const int LIMBS = 7; // количество разрядов мантиссы (не меньше 55 значащих цифр)
+	static const int DIGITS = 50; // количество значащих цифр при выводе
+
+private:
+	uint32_t limbs[LIMBS]; // разряды мантиссы, старший разряд ненулевой у ненулевого числа
+	long long exponent; // порядок по основанию 10^9
+	bool negative; // отрицательно ли число
+
+	void SetZero(); // обнуление числа
+	void Assign(const uint32_t *wide, size_t size, long long exponent, bool negative); // запись числа из разрядов с округлением до LIMBS разрядов
+
+	static int CompareMagnitude(const BigFloat& a, const BigFloat& b); // сравнение модулей
+	static BigFloat Add(const BigFloat& a, const BigFloat& b, bool subtract); // сложение или вычитание
+	static BigFloat Atan(long long n); // арктангенс 1/n для вычисления pi
+
+public:
+	BigFloat(long long value = 0); // конструктор из целого числа
+
+	static BigFloat FromString(const string& s); // создание из десятичной записи
+	static BigFloat FromDouble(double value); // создание из вещественного числа
+	static const BigFloat& Pi(); // число pi
+	static const BigFloat& E(); // число e
+
+	bool IsZero() const; // проверка на ноль
+	bool IsInteger() const; // проверка на целое число
+	int Sign() const; // знак числа
+	double ToDouble() const; // приближение вещественным числом
+	long long ToInteger() const; // целая часть в виде обычного целого числа
+	BigFloat Trunc() const; // целая часть с отбрасыванием дробной
+	BigFloat Power(long long exponent) const; // возведение в целую степень
+	BigFloat Sqrt() const; // квадратный корень
+
+	BigFloat operator-() const;
+	BigFloat operator+(const BigFloat& b) const;
+	BigFloat operator-(const BigFloat& b) const;
+	BigFloat operator*(const BigFloat& b) const;
+	BigFloat operator/(const BigFloat& b) const;
+
+	bool operator==(const BigFloat& b) const;
+	bool operator<(const BigFloat& b) const;
+	bool operator>(const BigFloat& b) const;
+
+	string ToString(int digits = DIGITS) const; // перевод в строку с заданным количеством значащих цифр
+};
+
+BigInteger::BigInteger(long long value) {
+	negative = value < 0;
+
+	unsigned long long magnitude = negative ? -(unsigned long long) value : value;
+
+	while (magnitude > 0) {
+		limbs.push_back(magnitude % LIMB_BASE);
+		magnitude /= LIMB_BASE;
+	}
+}
+
+// удаление ведущих нулевых разрядов
+void BigInteger::Trim() {
+	while (limbs.size() > 0 && limbs.back() == 0)
+		limbs.pop_back();
+
+	if (limbs.size() == 0) // у нуля нет знака
+		negative = false;
+}
+
+// сравнение модулей
+int BigInteger::CompareMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+	if (a.size() != b.size())
+		return a.size() < b.size() ? -1 : 1;
+
+	for (size_t i = a.size(); i > 0; i--)
+		if (a[i - 1] != b[i - 1])
+			return a[i - 1] < b[i - 1] ? -1 : 1;
+
+	return 0;
+}
+
+// сложение модулей
+vector<uint32_t> BigInteger::AddMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+	vector<uint32_t> result(max(a.size(), b.size()) + 1);
+	uint32_t carry = 0;
+
+	for (size_t i = 0; i < result.size(); i++) {
+		uint32_t sum = carry + (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+
+		carry = sum >= LIMB_BASE;
+		result[i] = carry ? sum - LIMB_BASE : sum;
+	}
+
+	return result;
+}
+
+// вычитание модулей, уменьшаемое не меньше вычитаемого
+vector<uint32_t> BigInteger::SubtractMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+	vector<uint32_t> result(a.size());
+	int64_t borrow = 0;
+
+	for (size_t i = 0; i < a.size(); i++) {
+		int64_t difference = (int64_t) a[i] - (i < b.size() ? b[i] : 0) - borrow;
+
+		borrow = difference < 0;
+		result[i] = borrow ? difference + LIMB_BASE : difference;
+	}
+
+	return result;
+}
+
+// создание из строки десятичных цифр
+BigInteger BigInteger::FromDigits(const string& digits) {
+	BigInteger result;
+
+	// разряды берутся по 9 цифр с конца строки
+	for (size_t end = digits.length(); end > 0; end = end > LIMB_DIGITS ? end - LIMB_DIGITS : 0) {
+		size_t start = end > LIMB_DIGITS ? end - LIMB_DIGITS : 0;
+
+		result.limbs.push_back(stoul(digits.substr(start, end - start)));
+	}
+
+	result.Trim();
+	return result;
+}
+
+// степень десяти
+BigInteger BigInteger::Power10(long long exponent) {
+	return FromDigits("1" + string(exponent, '0'));
+}
+
+// разбор десятичной записи вида 123.45e-6 на строку цифр и десятичный порядок
+void BigInteger::ParseDecimal(const string& s, string& digits, long long& exponent) {
+	size_t i = 0;
+
+	digits = "";
+	exponent = 0;
+
+	for (; i < s.length() && s[i] != 'e' && s[i] != 'E'; i++) {
+		if (s[i] == '.') {
+			exponent = -(long long) (s.length() - i - 1); // временно запоминаем позицию точки
+			continue;
+		}
+
+		if (s[i] < '0' || s[i] > '9')
+			throw string("incorrect real number '") + s + "'";
+
+		digits += s[i];
+	}
+
+	// порядок считается относительно конца цифр, а не конца строки
+	if (exponent < 0)
+		exponent += s.length() - i;
+
+	if (i < s.length())
+		exponent += stoll(s.substr(i + 1));
+
+	if (digits.length() == 0)
+		throw string("incorrect real number '") + s + "'";
+}
+
+// деление модулей по алгоритму D Кнута: u из m разрядов на v из n разрядов (m >= n, старший разряд v ненулевой)
+// частное q из m - n + 1 разрядов, остаток r из n разрядов (может быть nullptr), work - рабочая память из m + n + 1 разрядов
+void BigInteger::DivideLimbs(const uint32_t *u, size_t m, const uint32_t *v, size_t n, uint32_t *q, uint32_t *r, uint32_t *work) {
+	if (n == 1) { // деление на один разряд
+		uint64_t remainder = 0;
+
+		for (size_t i = m; i > 0; i--) {
+			uint64_t current = remainder * LIMB_BASE + u[i - 1];
+
+			q[i - 1] = current / v[0];
+			remainder = current % v[0];
+		}
+
+		if (r != nullptr)
+			r[0] = remainder;
+
+		return;
+	}
+
+	uint32_t *un = work; // нормализованное делимое из m + 1 разрядов
+	uint32_t *vn = work + m + 1; // нормализованный делитель из n разрядов
+	uint64_t d = LIMB_BASE / ((uint64_t) v[n - 1] + 1); // множитель, делающий старший разряд делителя не меньше половины основания
+	uint64_t carry = 0;
+
+	for (size_t i = 0; i < m; i++) {
+		uint64_t current = u[i] * d + carry;
+
+		un[i] = current % LIMB_BASE;
+		carry = current / LIMB_BASE;
+	}
+
+	un[m] = carry;
+	carry = 0;
+
+	for (size_t i = 0; i < n; i++) {
+		uint64_t current = v[i] * d + carry;
+
+		vn[i] = current % LIMB_BASE;
+		carry = current / LIMB_BASE;
+	}
+
+	for (size_t j = m - n + 1; j > 0; j--) {
+		size_t k = j - 1; // номер текущего разряда частного
+
+		// оценка разряда частного по двум старшим разрядам
+		uint64_t numerator = (uint64_t) un[k + n] * LIMB_BASE + un[k + n - 1];
+		uint64_t qhat = numerator / vn[n - 1];
+		uint64_t rhat = numerator % vn[n - 1];
+
+		while (qhat >= LIMB_BASE || qhat * vn[n - 2] > rhat * LIMB_BASE + un[k + n - 2]) {
+			qhat--;
+			rhat += vn[n - 1];
+
+			if (rhat >= LIMB_BASE)
+				break;
+		}
+
+		// вычитаем qhat * vn из текущей части делимого
+		int64_t borrow = 0;
+		carry = 0;
+
+		for (size_t i = 0; i < n; i++) {
+			uint64_t product = qhat * vn[i] + carry;
+			int64_t difference = (int64_t) un[i + k] - (int64_t) (product % LIMB_BASE) - borrow;
+
+			carry = product / LIMB_BASE;
+			borrow = difference < 0;
+			un[i + k] = borrow ? difference + LIMB_BASE : difference;
+		}
+
+		int64_t top = (int64_t) un[k + n] - (int64_t) carry - borrow;
+
+		// если оценка оказалась больше на единицу, возвращаем делитель обратно
+		if (top < 0) {
+			qhat--;
+			carry = 0;
+
+			for (size_t i = 0; i < n; i++) {
+				uint64_t sum = (uint64_t) un[i + k] + vn[i] + carry;
+
+				un[i + k] = sum % LIMB_BASE;
+				carry = sum / LIMB_BASE;
+			}
+
+			top += LIMB_BASE + carry;
+			top %= LIMB_BASE;
+		}
+
+		un[k + n] = top;
+		q[k] = qhat;
+	}
+
+	if (r == nullptr)
+		return;
+
+	// остаток получается делением нормализованного остатка на d
+	uint64_t remainder = 0;
+
+	for (size_t i = n; i > 0; i--) {
+		uint64_t current = remainder * LIMB_BASE + un[i - 1];
+
+		r[i - 1] = current / d;
+		remainder = current % d;
+	}
+}
+
+// деление с остатком, частное округляется к нулю, остаток имеет знак делимого
+void BigInteger::DivMod(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder) {
+	if (b.IsZero())
+		throw string("division by zero");
+
+	if (CompareMagnitude(a.limbs, b.limbs) < 0) {
+		quotient = 0;
+		remainder = a;
+		return;
+	}
+
+	size_t m = a.limbs.size();
+	size_t n = b.limbs.size();
+	vector<uint32_t> work(m + n + 1);
+
+	quotient.limbs.assign(m - n + 1, 0);
+	remainder.limbs.assign(n, 0);
+
+	DivideLimbs(a.limbs.data(), m, b.limbs.data(), n, quotient.limbs.data(), remainder.limbs.data(), work.data());
+
+	quotient.negative = a.negative != b.negative;
+	remainder.negative = a.negative;
+	quotient.Trim();
+	remainder.Trim();
+}
+
+// наибольший общий делитель по алгоритму Евклида
+BigInteger BigInteger::Gcd(BigInteger a, BigInteger b) {
+	a.negative = false;
+	b.negative = false;
+
+	while (!b.IsZero()) {
+		BigInteger r = a % b;
+
+		a = b;
+		b = r;
+	}
+
+	return a;
+}
+
+// проверка на ноль
+bool BigInteger::IsZero() const {
+	return limbs.size() == 0;
+}
+
+// проверка на отрицательность
+bool BigInteger::IsNegative() const {
+	return negative;
+}
+
+// сравнение с числом: -1, 0 или 1
+int BigInteger::Compare(const BigInteger& b) const {
+	if (negative != b.negative)
+		return negative ? -1 : 1;
+
+	int compare = CompareMagnitude(limbs, b.limbs);
+
+	return negative ? -compare : compare;
+}
+
+// перевод в обычное целое число, модуль должен быть меньше 10^18
+long long BigInteger::ToInteger() const {
+	if (limbs.size() > 2)
+		throw string("number is too large");
+
+	long long value = 0;
+
+	for (size_t i = limbs.size(); i > 0; i--)
+		value = value * LIMB_BASE + limbs[i - 1];
+
+	return negative ? -value : value;
+}
+
+// десятичный логарифм модуля по старшему разряду: количество цифр степени не больше показателя, умноженного на эту оценку, плюс один
+double BigInteger::Length() const {
+	if (limbs.empty())
+		return 0;
+
+	return (limbs.size() - 1) * LIMB_DIGITS + log10((double) limbs.back());
+}
+
+BigInteger BigInteger::operator-() const {
+	BigInteger result = *this;
+
+	result.negative = !negative;
+	result.Trim();
+
+	return result;
+}
+
+BigInteger BigInteger::operator+(const BigInteger& b) const {
+	BigInteger result;
+
+	if (negative == b.negative) {
+		result.limbs = AddMagnitude(limbs, b.limbs);
+		result.negative = negative;
+	}
+	else if (CompareMagnitude(limbs, b.limbs) >= 0) {
+		result.limbs = SubtractMagnitude(limbs, b.limbs);
+		result.negative = negative;
+	}
+	else {
+		result.limbs = SubtractMagnitude(b.limbs, limbs);
+		result.negative = b.negative;
+	}
+
+	result.Trim();
+	return result;
+}
+
+BigInteger BigInteger::operator-(const BigInteger& b) const {
+	return *this + (-b);
+}
+
+BigInteger BigInteger::operator*(const BigInteger& b) const {
+	BigInteger result;
+
+	if (IsZero() || b.IsZero())
+		return result;
+
+	result.limbs.assign(limbs.size() + b.limbs.size(), 0);
+
+	for (size_t i = 0; i < limbs.size(); i++) {
+		uint64_t carry = 0;
+
+		for (size_t j = 0; j < b.limbs.size(); j++) {
+			uint64_t current = (uint64_t) limbs[i] * b.limbs[j] + result.limbs[i + j] + carry;
+
+			result.limbs[i + j] = current % LIMB_BASE;
+			carry = current / LIMB_BASE;
+		}
+
+		result.limbs[i + b.limbs.size()] = carry;
+	}
+
+	result.negative = negative != b.negative;
+	result.Trim();
+
+	return result;
+}
+
+BigInteger BigInteger::operator/(const BigInteger& b) const {
+	BigInteger quotient, remainder;
+	DivMod(*this, b, quotient, remainder);
+
+	return quotient;
+}
+
+BigInteger BigInteger::operator%(const BigInteger& b) const {
+	BigInteger quotient, remainder;
+	DivMod(*this, b, quotient, remainder);
+
+	return remainder;
+}
+
+bool BigInteger::operator==(const BigInteger& b) const {
+	return Compare(b) == 0;
+}
+
+bool BigInteger::operator<(const BigInteger& b) const {
+	return Compare(b) < 0;
+}
+
+// перевод в строку
+string BigInteger::ToString() const {
+	if (IsZero())
+		return "0";
+
+	string s = (negative ? "-" : "") + to_string(limbs.back());
+
+	for (size_t i = limbs.size() - 1; i > 0; i--) {
+		string limb = to_string(limbs[i - 1]);
+
+		s += string(LIMB_DIGITS - limb.length(), '0') + limb; // дополняем разряд нулями до 9 цифр
+	}
+
+	return s;
+}
+
+Rational::Rational(long long value) : numerator(value), denominator(1) {
+}
+
+Rational::Rational(const BigInteger& numerator, const BigInteger& denominator) : numerator(numerator), denominator(denominator) {
+	if (denominator.IsZero())
+		throw string("division by zero");
+
+	Normalize();
+}
+
+// сокращение дроби и перенос знака в числитель
+void Rational::Normalize() {
+	if (denominator.IsNegative()) {
+		numerator = -numerator;
+		denominator = -denominator;
+	}
+
+	BigInteger gcd = BigInteger::Gcd(numerator, denominator);
+
+	if (!(gcd == 1) && !gcd.IsZero()) {
+		numerator = numerator / gcd;
+		denominator = denominator / gcd;
+	}
+}
+
+// создание из десятичной записи: 1.25 = 125/100 = 5/4
+Rational Rational::FromString(const string& s) {
+	string digits;
+	long long exponent;
+
+	BigInteger::ParseDecimal(s, digits, exponent);
+
+	if (exponent >= 0)
+		return Rational(BigInteger::FromDigits(digits) * BigInteger::Power10(exponent), 1);
+
+	return Rational(BigInteger::FromDigits(digits), BigInteger::Power10(-exponent));
+}
+
+// проверка на целое число
+bool Rational::IsInteger() const {
+	return denominator == 1;
+}
+
+// знак дроби
+int Rational::Sign() const {
+	return numerator.IsZero() ? 0 : numerator.IsNegative() ? -1 : 1;
+}
+
+// целая часть с отбрасыванием дробной
+BigInteger Rational::Trunc() const {
+	return numerator / denominator;
+}
+
+// целая часть в виде обычного целого числа
+long long Rational::ToInteger() const {
+	return Trunc().ToInteger();
+}
+
+// оценка количества цифр наибольшего из числителя и знаменателя
+double Rational::Length() const {
+	return max(numerator.Length(), denominator.Length());
+}
+
+// возведение в целую степень быстрым возведением
+Rational Rational::Power(long long exponent) const {
+	Rational base = exponent < 0 ? Rational(1) / *this : *this;
+	Rational result(1);
+	unsigned long long n = exponent < 0 ? -(unsigned long long) exponent : exponent;
+
+	while (n > 0) {
+		if (n & 1)
+			result = result * base;
+
+		base = base * base;
+		n >>= 1;
+	}
+
+	return result;
+}
+
+Rational Rational::operator-() const {
+	return Rational(-numerator, denominator);
+}
+
+Rational Rational::operator+(const Rational& b) const {
+	return Rational(numerator * b.denominator + b.numerator * denominator, denominator * b.denominator);
+}
+
+Rational Rational::operator-(const Rational& b) const {
+	return Rational(numerator * b.denominator - b.numerator * denominator, denominator * b.denominator);
+}
+
+Rational Rational::operator*(const Rational& b) const {
+	return Rational(numerator * b.numerator, denominator * b.denominator);
+}
+
+Rational Rational::operator/(const Rational& b) const {
+	if (b.numerator.IsZero())
+		throw string("division by zero");
+
+	return Rational(numerator * b.denominator, denominator * b.numerator);
+}
+
+bool Rational::operator==(const Rational& b) const {
+	return numerator == b.numerator && denominator == b.denominator;
+}
+
+bool Rational::operator<(const Rational& b) const {
+	return numerator * b.denominator < b.numerator * denominator;
+}
+
+bool Rational::operator>(const Rational& b) const {
+	return b < *this;
+}
+
+// перевод в строку вида p/q, у целых чисел знаменатель не выводится
+string Rational::ToString() const {
+	return IsInteger() ? numerator.ToString() : numerator.ToString() + "/" + denominator.ToString();
+}
+
+BigFloat::BigFloat(long long value) {
+	uint32_t wide[3] = { 0, 0, 0 };
+	unsigned long long magnitude = value < 0 ? -(unsigned long long) value : value;
+
+	for (int i = 0; i < 3; i++) {
+		wide[i] = magnitude % LIMB_BASE;
+		magnitude /= LIMB_BASE;
+	}
+
+	Assign(wide, 3, 0, value < 0);
+}
+
+// обнуление числа
+void BigFloat::SetZero() {
+	for (int i = 0; i < LIMBS; i++)
+		limbs[i] = 0;
+
+	exponent = 0;
+	negative = false;
+}
+
+// запись числа из size разрядов wide с порядком exponent, мантисса округляется до LIMBS старших разрядов
+void BigFloat::Assign(const uint32_t *wide, size_t size, long long exponent, bool negative) {
+	long long top = (long long) size - 1;
+
+	while (top >= 0 && wide[top] == 0)
+		top--;
+
+	if (top < 0) {
+		SetZero();
+		return;
+	}
+
+	long long shift = top - (LIMBS - 1); // на сколько разрядов сдвигается мантисса
+	bool roundUp = shift > 0 && wide[shift - 1] >= LIMB_BASE / 2; // округление по первому отброшенному разряду
+
+	for (int i = 0; i < LIMBS; i++)
+		limbs[i] = i + shift >= 0 ? wide[i + shift] : 0;
+
+	this->exponent = exponent + shift;
+	this->negative = negative;
+
+	if (!roundUp)
+		return;
+
+	int i = 0;
+
+	while (i < LIMBS && ++limbs[i] == LIMB_BASE)
+		limbs[i++] = 0;
+
+	// если перенос вышел за мантиссу, она стала равна 10^(9 * LIMBS)
+	if (i == LIMBS) {
+		limbs[LIMBS - 1] = 1;
+		this->exponent++;
+	}
+}
+
+// сравнение модулей: у нормализованных чисел старший разряд ненулевой, поэтому сначала сравниваются порядки
+int BigFloat::CompareMagnitude(const BigFloat& a, const BigFloat& b) {
+	if (a.IsZero() || b.IsZero())
+		return (a.IsZero() ? 0 : 1) - (b.IsZero() ? 0 : 1);
+
+	if (a.exponent != b.exponent)
+		return a.exponent < b.exponent ? -1 : 1;
+
+	for (int i = LIMBS - 1; i >= 0; i--)
+		if (a.limbs[i] != b.limbs[i])
+			return a.limbs[i] < b.limbs[i] ? -1 : 1;
+
+	return 0;
+}
+
+// сложение (или вычитание при subtract) в буфере, выровненном по порядку меньшего числа
+BigFloat BigFloat::Add(const BigFloat& a, const BigFloat& b, bool subtract) {
+	BigFloat x = a;
+	BigFloat y = b;
+
+	y.negative = b.negative != subtract;
+
+	if (y.IsZero())
+		return x;
+
+	if (x.IsZero())
+		return y;
+
+	if (CompareMagnitude(x, y) < 0) // x - число с большим модулем
+		swap(x, y);
+
+	long long shift = x.exponent - y.exponent;
+
+	// меньшее число не влияет на разряды результата
+	if (shift > LIMBS + 1)
+		return x;
+
+	uint32_t wide[2 * LIMBS + 3] = { 0 };
+	size_t size = LIMBS + shift + 1;
+
+	for (int i = 0; i < LIMBS; i++)
+		wide[i + shift] = x.limbs[i];
+
+	if (x.negative == y.negative) {
+		uint32_t carry = 0;
+
+		for (size_t i = 0; i < size; i++) {
+			uint32_t sum = wide[i] + (i < LIMBS ? y.limbs[i] : 0) + carry;
+
+			carry = sum >= LIMB_BASE;
+			wide[i] = carry ? sum - LIMB_BASE : sum;
+		}
+	}
+	else {
+		int64_t borrow = 0;
+
+		for (size_t i = 0; i < size; i++) {
+			int64_t difference = (int64_t) wide[i] - (i < LIMBS ? y.limbs[i] : 0) - borrow;
+
+			borrow = difference < 0;
+			wide[i] = borrow ? difference + LIMB_BASE : difference;
+		}
+	}
+
+	BigFloat result;
+	result.Assign(wide, size, y.exponent, x.negative);
+
+	return result;
+}
+
+// арктангенс 1/n рядом Тейлора: 1/n - 1/(3n^3) + 1/(5n^5) - ...
+BigFloat BigFloat::Atan(long long n) {
+	BigFloat power = BigFloat(1) / BigFloat(n); // 1 / n^(2k+1)
+	BigFloat n2 = BigFloat(n * n);
+	BigFloat sum = power;
+
+	for (long long k = 1; ; k++) {
+		power = power / n2;
+
+		BigFloat term = power / BigFloat(2 * k + 1);
+
+		// слагаемое меньше последнего разряда суммы
+		if (term.IsZero() || term.exponent + LIMBS < sum.exponent)
+			break;
+
+		sum = k % 2 ? sum - term : sum + term;
+	}
+
+	return sum;
+}
+
+// создание из десятичной записи, числа до 55 значащих цифр представляются точно
+BigFloat BigFloat::FromString(const string& s) {
+	string digits;
+	long long exponent;
+
+	BigInteger::ParseDecimal(s, digits, exponent);
+
+	// приводим порядок к кратному 9, дописывая нули к цифрам
+	long long pad = ((exponent % LIMB_DIGITS) + LIMB_DIGITS) % LIMB_DIGITS;
+
+	digits += string(pad, '0');
+	exponent -= pad;
+
+	vector<uint32_t> wide;
+
+	for (size_t end = digits.length(); end > 0; end = end > LIMB_DIGITS ? end - LIMB_DIGITS : 0) {
+		size_t start = end > LIMB_DIGITS ? end - LIMB_DIGITS : 0;
+
+		wide.push_back(stoul(digits.substr(start, end - start)));
+	}
+
+	BigFloat result;
+	result.Assign(wide.data(), wide.size(), exponent / LIMB_DIGITS, false);
+
+	return result;
+}
+
+// создание из вещественного числа по его кратчайшему точному десятичному представлению
+BigFloat BigFloat::FromDouble(double value) {
+	if (!isfinite(value))
+		throw string("value is not finite");
+
+	ostringstream stream;
+	stream << scientific << setprecision(17) << fabs(value);
+
+	BigFloat result = FromString(stream.str());
+
+	return value < 0 ? -result : result;
+}
+
+// число pi по формуле Мэчина: pi = 16 atan(1/5) - 4 atan(1/239)
+const BigFloat& BigFloat::Pi() {
+	static const BigFloat pi = BigFloat(16) * Atan(5) - BigFloat(4) * Atan(239);
+
+	return pi;
+}
+
+// число e как сумма ряда 1/k!
+const BigFloat& BigFloat::E() {
+	static const BigFloat e = []() {
+		BigFloat sum = 2;
+		BigFloat term = 1;
+
+		for (long long k = 2; ; k++) {
+			term = term / BigFloat(k);
+
+			if (term.IsZero() || term.exponent + LIMBS < sum.exponent)
+				break;
+
+			sum = sum + term;
+		}
+
+		return sum;
+	}();
+
+	return e;
+}
+
+// проверка на ноль
+bool BigFloat::IsZero() const {
+	return limbs[LIMBS - 1] == 0;
+}
+
+// проверка на целое число: все разряды дробной части нулевые
+bool BigFloat::IsInteger() const {
+	for (int i = 0; i < LIMBS; i++)
+		if (exponent + i < 0 && limbs[i] != 0)
+			return false;
+
+	return true;
+}
+
+// знак числа
+int BigFloat::Sign() const {
+	return IsZero() ? 0 : negative ? -1 : 1;
+}
+
+// приближение вещественным числом
+double BigFloat::ToDouble() const {
+	double value = 0;
+
+	for (int i = 0; i < LIMBS; i++)
+		value += limbs[i] * pow((double) LIMB_BASE, (double) (exponent + i));
+
+	return negative ? -value : value;
+}
+
+// целая часть в виде обычного целого числа
+long long BigFloat::ToInteger() const {
+	if (exponent + LIMBS > 2) // модуль больше 10^18
+		throw string("number is too large");
+
+	long long value = 0;
+
+	for (int i = LIMBS - 1; i >= 0; i--)
+		if (exponent + i >= 0)
+			value = value * LIMB_BASE + limbs[i];
+
+	return negative ? -value : value;
+}
+
+// целая часть с отбрасыванием дробной
+BigFloat BigFloat::Trunc() const {
+	uint32_t wide[LIMBS];
+
+	for (int i = 0; i < LIMBS; i++)
+		wide[i] = exponent + i < 0 ? 0 : limbs[i];
+
+	BigFloat result;
+	result.Assign(wide, LIMBS, exponent, negative);
+
+	return result;
+}
+
+// возведение в целую степень быстрым возведением
+BigFloat BigFloat::Power(long long exponent) const {
+	BigFloat base = exponent < 0 ? BigFloat(1) / *this : *this;
+	BigFloat result = 1;
+	unsigned long long n = exponent < 0 ? -(unsigned long long) exponent : exponent;
+
+	while (n > 0) {
+		if (n & 1)
+			result = result * base;
+
+		base = base * base;
+		n >>= 1;
+	}
+
+	return result;
+}
+
+// квадратный корень методом Ньютона, начальное приближение вычисляется в double
+BigFloat BigFloat::Sqrt() const {
+	if (negative && !IsZero())
+		throw string("square root of negative number");
+
+	if (IsZero())
+		return *this;
+
+	// число равно m * (10^9)^e, m из старших разрядов в [1, 10^9); при нечётном e один разряд переносится в m,
+	// тогда начальное приближение sqrt(m) * (10^9)^(e/2) не выходит за диапазон double при любом порядке числа
+	double mantissa = 0;
+	long long order = exponent + LIMBS - 1;
+
+	for (int i = LIMBS - 1; i >= LIMBS - 3; i--)
+		mantissa += limbs[i] * pow((double) LIMB_BASE, (double) (i - LIMBS + 1));
+
+	if (order % 2 != 0) {
+		mantissa *= LIMB_BASE;
+		order--;
+	}
+
+	BigFloat x = FromDouble(sqrt(mantissa));
+	BigFloat half = FromString("0.5");
+
+	x.exponent += order / 2;
+
+	// каждая итерация удваивает количество верных цифр: 16 -> 32 -> 64
+	for (int i = 0; i < 4; i++)
+		x = (x + *this / x) * half;
+
+	return x;
+}
+
+BigFloat BigFloat::operator-() const {
+	BigFloat result = *this;
+
+	if (!IsZero())
+		result.negative = !negative;
+
+	return result;
+}
+
+BigFloat BigFloat::operator+(const BigFloat& b) const {
+	return Add(*this, b, false);
+}
+
+BigFloat BigFloat::operator-(const BigFloat& b) const {
+	return Add(*this, b, true);
+}
+
+BigFloat BigFloat::operator*(const BigFloat& b) const {
+	uint32_t wide[2 * LIMBS] = { 0 };
+
+	for (int i = 0; i < LIMBS; i++) {
+		uint64_t carry = 0;
+
+		for (int j = 0; j < LIMBS; j++) {
+			uint64_t current = (uint64_t) limbs[i] * b.limbs[j] + wide[i + j] + carry;
+
+			wide[i + j] = current % LIMB_BASE;
+			carry = current / LIMB_BASE;
+		}
+
+		wide[i + LIMBS] = carry;
+	}
+
+	BigFloat result;
+	result.Assign(wide, 2 * LIMBS, exponent + b.exponent, negative != b.negative);
+
+	return result;
+}
+
+// деление мантисс: делимое дополняется LIMBS + 1 нулевыми разрядами, чтобы частное имело не меньше LIMBS + 1 разрядов
+BigFloat BigFloat::operator/(const BigFloat& b) const {
+	if (b.IsZero())
+		throw string("division by zero");
+
+	const size_t m = 2 * LIMBS + 1;
+	uint32_t u[m] = { 0 };
+	uint32_t q[m - LIMBS + 1];
+	uint32_t work[m + LIMBS + 1];
+
+	for (int i = 0; i < LIMBS; i++)
+		u[i + LIMBS + 1] = limbs[i];
+
+	BigInteger::DivideLimbs(u, m, b.limbs, LIMBS, q, nullptr, work);
+
+	BigFloat result;
+	result.Assign(q, m - LIMBS + 1, exponent - b.exponent - (LIMBS + 1), negative != b.negative);
+
+	return result;
+}
+
+bool BigFloat::operator==(const BigFloat& b) const {
+	return Sign() == b.Sign() && CompareMagnitude(*this, b) == 0;
+}
+
+bool BigFloat::operator<(const BigFloat& b) const {
+	if (Sign() != b.Sign())
+		return Sign() < b.Sign();
+
+	int compare = CompareMagnitude(*this, b);
+
+	return negative ? compare > 0 : compare < 0;
+}
+
+bool BigFloat::operator>(const BigFloat& b) const {
+	return b < *this;
+}
+
+// перевод в строку с округлением до digits значащих цифр
+string BigFloat::ToString(int digits) const {
+	if (IsZero())
+		return "0";
+
+	string mantissa = to_string(limbs[LIMBS - 1]);
+
+	for (int i = LIMBS - 2; i >= 0; i--) {
+		string limb = to_string(limbs[i]);
+
+		mantissa += string(LIMB_DIGITS - limb.length(), '0') + limb;
+	}
+
+	long long point = (long long) to_string(limbs[LIMBS - 1]).length() + LIMB_DIGITS * (exponent + LIMBS - 1); // количество цифр до точки
+
+	// округляем до нужного количества цифр
+	if ((int) mantissa.length() > digits) {
+		bool roundUp = mantissa[digits] >= '5';
+
+		mantissa = mantissa.substr(0, digits);
+
+		for (int i = digits - 1; roundUp && i >= 0; i--) {
+			roundUp = mantissa[i] == '9';
+			mantissa[i] = roundUp ? '0' : mantissa[i] + 1;
+		}
+
+		if (roundUp) { // перенос в новый разряд
+			mantissa = "1" + mantissa.substr(0, digits - 1);
+			point++;
+		}
+	}
+
+	// удаляем незначащие нули в конце
+	while (mantissa.length() > 1 && mantissa.back() == '0')
+		mantissa.pop_back();
+
+	string s = negative ? "-" : "";
+	long long length = mantissa.length();
+
+	if (point > digits || point < -digits) // экспоненциальная запись для очень больших и очень маленьких чисел
+		return s + mantissa.substr(0, 1) + (length > 1 ? "." + mantissa.substr(1) : "") + "e" + to_string(point - 1);
+
+	if (point <= 0)
+		return s + "0." + string(-point, '0') + mantissa;
+
+	if (length <= point)
+		return s + mantissa + string(point - length, '0');
+
+	return s + mantissa.substr(0, point) + "." + mantissa.substr(point);
+}
@@ -2,27 +2,71 @@
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <stack>
+#include <unordered_map>
 #include <cmath>
+#include <cfloat>
+#include <cstdlib>
+#include <future>
+#include <thread>
+
+#include "BigNumbers.hpp"
+#include "ThreadPool.hpp"
 
 using namespace std;
 
+// точность вычисления встроенных функций
+enum class Precision {
+	Strict, // функции стандартной библиотеки
+	Fast, // быстрые полиномиальные приближения
+	Float // вычисление в одинарной точности
+};
+
+// арифметика вычисления выражений
+enum class Arithmetic {
+	Double, // вещественные числа двойной точности
+	Exact, // точные рациональные дроби
+	Precise // десятичные числа с 50 значащими цифрами
+};
+
+typedef double (*NativeKernel)(const double *args); // ядро встроенной функции от массива аргументов
+typedef void (*NativeBatchKernel)(const double *args, double *results, size_t count); // пакетное ядро: j-й аргумент k-й точки находится в args[j * count + k]
+
 class Calculator {
 	const string DEF = "def"; // строка для определения функции
 	const string SET = "set"; // строка для введения переменной
+	const string DIFF = "diff"; // строка для дифференцирования функции
+	const string DOUBLE = "double"; // строка для вычисления в двойной точности
+	const string EXACT = "exact"; // строка для точного вычисления в дробях
+	const string PRECISE = "precise"; // строка для вычисления с повышенной точностью
+
+	const double INTEGRATION_EPS = 1e-10; // точность численного интегрирования
+	const int INTEGRATION_DEPTH = 20; // максимальная глубина адаптивного разбиения отрезка
+	const double SOLVE_EPS = 1e-15; // относительная точность поиска корня
+	const int SOLVE_ITERATIONS = 200; // максимальное число итераций поиска корня
+	const int ACCURACY_SAMPLES = 100000; // количество точек для оценки точности функций
+	const double ACCURACY_PERIODIC_LIMIT = 1e5; // граница точек k * pi/2 для оценки точности тригонометрических функций
+	const double FAST_SINCOS_ULP = 2; // допустимая ошибка быстрых синуса и косинуса
+	const double FAST_TANCOT_ULP = 4; // допустимая ошибка быстрых тангенса и котангенса
+	const double FLOAT_ULP = 2; // допустимая ошибка функций одинарной точности в единицах её последнего разряда
+	const size_t DIFF_LIMIT = 100000; // максимальное количество узлов, создаваемых при построении производной
+	const size_t SUM_BATCH = 256; // количество точек, вычисляемых за один пакет при суммировании
+	const double SUM_LIMIT = 1e8; // максимальное количество слагаемых суммы
+	const long long POWER_LIMIT = 100000; // максимальный показатель степени в точной арифметике
+	const double POWER_DIGITS = 100000; // максимальное оценённое количество цифр степени в точной арифметике
+
+	static constexpr double PIO2_1 = 1.57079632673412561417e+00; // старшие 33 бита pi/2
+	static constexpr double PIO2_2 = 6.07710050630396597660e-11; // следующие 33 бита pi/2
+	static constexpr double PIO2_3 = 2.02226624879595063154e-21; // остаток pi/2 - PIO2_1 - PIO2_2
+	static constexpr double ROUND_SHIFT = 6755399441055744.0; // 1.5 * 2^52: сложение с ним округляет до целого
 	
-	// вектор функций одного аргумента
-	const vector<string> functions = {
-		"sin", "cos", "tan", "tg", "cot", "ctg", 
-		"asin", "arcsin", "acos", "arccos", "atan", "arctan", "arctg", 
-		"sqrt", "ln", "lg", "exp", "abs", "sign"
-	};
 
-	// вектор функций двух аргументов
-	const vector<string> functionsBinary = {
-		"pow", "log", "min", "max"
+	// вектор операторов над пользовательскими функциями
+	const vector<string> functionals = {
+		"integrate", "solve", "sum"
 	};
 
 	// вектор констант
@@ -34,6 +78,102 @@ class Calculator {
 	struct Variable {
 		string name; // имя переменной
 		double value;
+		vector<string> rpn; // полиз выражения для вычисления в других арифметиках
+	};
+
+	// перевод градусов для встроенной функции
+	enum class Angle {
+		None, // не требуется
+		Argument, // аргумент переводится из градусов в радианы
+		Result // значение переводится из радиан в градусы
+	};
+
+	// вычисление встроенной функции в точной и длинной арифметике
+	enum class Exact {
+		None, // не поддерживается
+		Abs, // модуль
+		Sign, // знак
+		Min, // минимум
+		Max, // максимум
+		Pow, // целая степень
+		Sqrt // квадратный корень (только в длинной арифметике)
+	};
+
+	// структура для встроенной функции
+	struct NativeFunction {
+		string name; // имя функции
+		size_t arity; // количество аргументов
+		NativeKernel kernel; // ядро функции
+		NativeBatchKernel batch; // пакетное ядро функции (может отсутствовать)
+		bool pure; // зависит ли значение только от аргументов
+		Angle angle; // перевод градусов
+		vector<NativeKernel> partials; // частные производные по каждому аргументу (могут отсутствовать)
+		bool single; // вычисляется ли ядро от аргументов одинарной точности
+		Exact exact; // вычисление в точной и длинной арифметике, выбирается при регистрации
+	};
+
+	// тип инструкции скомпилированной функции
+	enum class OpCode {
+		Number, // число или константа
+		Argument, // аргумент функции
+		Negate, // унарный минус
+		Scale, // умножение на число (перевод градусов в радианы и обратно)
+		Operator, // бинарная операция
+		Native, // встроенная функция
+		UserFunction, // пользовательская функция
+		Functional // оператор над пользовательской функцией
+	};
+
+	// бинарная операция скомпилированной функции
+	enum class Operation {
+		Add, // сложение
+		Subtract, // вычитание
+		Multiply, // умножение
+		Divide, // деление
+		Mod, // остаток от деления
+		Power // возведение в степень
+	};
+
+	// структура для инструкции скомпилированной функции
+	struct Instruction {
+		OpCode code; // тип инструкции
+		string name; // имя операции или функции
+		double value; // значение числа
+		size_t index; // индекс встроенной или пользовательской функции
+		Operation operation; // бинарная операция, чтобы не сравнивать строки при вычислении
+	};
+
+	// структура для дуального числа (значение и производная)
+	struct Dual {
+		double value; // значение
+		double derivative; // значение производной
+
+		Dual(double value = 0, double derivative = 0) : value(value), derivative(derivative) {}
+
+		Dual operator-() const {
+			return Dual(-value, -derivative);
+		}
+
+		Dual operator*(double scale) const {
+			return Dual(value * scale, derivative * scale);
+		}
+	};
+
+	// структура для узла дерева выражения
+	struct Node {
+		string token; // лексема узла
+		string function; // имя функции для операторов над пользовательскими функциями
+		vector<Node> args; // аргументы узла
+	};
+
+	// структура для ошибки встроенной функции на отрезке или в точках k * pi/2
+	struct Accuracy {
+		string name; // имя функции
+		double a; // начало отрезка
+		double b; // конец отрезка или граница точек k * pi/2
+		bool periodic; // оценивается ли ошибка в точках k * pi/2
+		double error; // максимальная ошибка в единицах последнего разряда
+		double arg; // аргумент с максимальной ошибкой
 	};
 
 	// структура для функции
@@ -41,9 +181,13 @@ class Calculator {
 		string name; // имя функции
 		string arg; // имя аргумента
 		vector<string> rpn; // полиз функции
+		vector<Instruction> program; // скомпилированный полиз функции
+		bool pure; // зависит ли значение только от аргумента
 	};
 
 	bool degrees; // в градусах ли вычисление тригонометрии
+	Precision precision; // точность вычисления встроенных функций
+	Arithmetic arithmetic; // арифметика вычисления выражений по умолчанию
 
 	vector<string> lexemes; // вектор лексем
 	vector<string> rpn; // обратная польская запись выражения
@@ -51,6 +195,11 @@ class Calculator {
 	vector<Variable> userVariables; // вектор пользовательских переменных
 	vector<Function> userFunctions; // вектор пользовательских функций
 
+	vector<NativeFunction> natives; // вектор встроенных функций
+	unordered_map<string, size_t> nativeIndices; // индексы встроенных функций по именам
+	size_t powIndex; // индекс функции pow для операции возведения в степень
+	mutable size_t treeBudget; // сколько ещё узлов можно создать при построении производной
+
 	void SplitToLexemes(const string& s); // разбивка на лексемы
 
 	string CurrLexeme(); // получение текущей дексемы
@@ -58,13 +207,15 @@ class Calculator {
 	void CheckLexeme(const string& value); // проверка на совпадение с ожидаемой лексемой
 
 	bool IsNumber(const string& s) const; // проверка на число
+	double ParseNumber(const string& s) const; // получение значения числа в двойной точности
 	bool IsConstant(const string& s) const; // проверка на константу
 	bool IsIdentifier(const string& s) const; // проверка на идентификатор (переменную)
 	bool IsOperator(const string& s) const; // проверка на операцию
+	Operation GetOperation(const string& op) const; // получение кода операции по её имени
 	bool IsUserVariable(const string& s) const; // проверка на пользовательскую переменную
 	bool IsUserFunction(const string& s) const; // проверка на пользовательскую функцию
-	bool IsFunction(const string& s) const; // проверка на функцию одного аргумента
-	bool IsBinaryFunction(const string& s) const; // проверка на функцию двух аргументов
+	bool IsNative(const string& s) const; // проверка на встроенную функцию
+	bool IsFunctional(const string& s) const; // проверка на оператор над пользовательской функцией
 
 	void Addition(); // обработка аддитивных операций
 	void Multiplying(bool isUnary = true); // обработка мультипликативных операций
@@ -73,28 +224,106 @@ class Calculator {
 
 	void ParseSet(); // обработка введения переменной
 	void ParseDef(); // обработка введения функции
+	void ParseDiff(); // обработка дифференцирования функции
+	void CheckFunctionName(const string& name) const; // проверка имени новой пользовательской функции
 
 	const Variable* GetVariable(const string& name) const; // получение указателя на переменную по её имени
 	const Function* GetFunction(const string& name) const; // получение указателя на функцию по её имени
+	size_t GetFunctionIndex(const string& name) const; // получение индекса функции по её имени
+	const NativeFunction& GetNative(const string& name) const; // получение встроенной функции по её имени
+
+	void RegisterBuiltins(); // регистрация встроенных функций выбранной точности
+	void RegisterAlias(const string& alias, const string& name); // регистрация другого имени встроенной функции
+	void SetDerivatives(const string& name, Angle angle, const vector<NativeKernel>& partials); // задание перевода градусов и частных производных
+
+	vector<Instruction> Compile(const vector<string>& rpn, const string& arg) const; // компиляция полиза функции
+	void Fold(vector<Instruction>& program) const; // свёртка последней инструкции с числовыми аргументами
+	bool IsPure(const vector<Instruction>& program) const; // проверка, что функция зависит только от аргумента
+	template <typename T>
+	T Execute(const vector<Instruction>& program, T arg, vector<T>& frame) const; // выполнение скомпилированной функции
+	void ExecuteBatch(const vector<Instruction>& program, const double *args, double *results, size_t count, vector<double>& frame) const; // выполнение скомпилированной функции для массива аргументов
+	void EvaluateOperatorBatch(Operation op, double *arg1, const double *arg2, size_t count) const; // вычисление операции над массивами
+
+	size_t TreeSize(const Node& node) const; // количество узлов дерева выражения
+	void SpendNodes(size_t count) const; // учёт созданных узлов в пределах ограничения размера производной
+	Node MakeNode(const string& token, const vector<Node>& args = {}) const; // создание узла дерева выражения
+	Node MakeNumber(double value) const; // создание узла с числом
+	bool IsValue(const Node& node, double& value) const; // проверка, является ли узел числом
+	Node BuildTree(const vector<string>& rpn, const string& arg, const Node *replacement) const; // построение дерева выражения по полизу
+	Node Derivative(const Node& node, const string& arg) const; // символьное дифференцирование дерева выражения
+	Node Simplify(const Node& node) const; // упрощение дерева выражения
+	void ToRpn(const Node& node, vector<string>& rpn) const; // перевод дерева выражения в полиз
+
+	double Integrate(const Function& function, double a, double b) const; // численное интегрирование функции
+	double IntegratePanel(const Function& function, double a, double b, double fa, double fm, double fb, double whole, double eps, int depth, vector<double>& frame) const; // адаптивный метод Симпсона на отрезке
+	double Solve(const Function& function, double lo, double hi) const; // поиск корня функции на отрезке
+	double Sum(const Function& function, double a, double b) const; // сумма значений функции в целых точках отрезка
+	double SumTerms(double a, double b) const; // количество слагаемых суммы с проверкой границ
 
 	double EvaluateConstant(const string& constant) const; // получение значения константы
 	double EvaluateOperator(const string& op, double arg1, double arg2) const; // вычисление значения операции
-	double EvaluateFunction(const string& name, double arg) const; // вычисление значения функции
-	double EvaluateBinaryfunction(const string& name, double arg1, double arg2) const; // вычисление значения бинарной функции
-	double Evaluate(const vector<string>& rpn) const; // вычисление выражения, записанного в ПОЛИЗе
+	double EvaluateOperator(Operation op, double arg1, double arg2) const; // вычисление значения операции по её коду
+	double EvaluateNative(const NativeFunction& native, const double *args) const; // вычисление встроенной функции с учётом режима тригонометрии
+	double ApplyNative(const NativeFunction& native, const double *args) const; // вычисление встроенной функции от аргумента в радианах
+	double EvaluateFunctional(const string& name, const Function& function, double arg1, double arg2) const; // вычисление оператора над функцией
+
+	static double RoundNearest(double x); // округление до ближайшего целого без вызова библиотеки
+	static int ReduceAngle(double x, double& r); // приведение угла к отрезку [-pi/4, pi/4]
+	static double SinPolynomial(double r); // синус на отрезке [-pi/4, pi/4]
+	static double CosPolynomial(double r); // косинус на отрезке [-pi/4, pi/4]
+	static double FastSin(double x); // быстрый синус
+	static double FastCos(double x); // быстрый косинус
+	static double FastTan(double x); // быстрый тангенс
+	double UlpError(double value, double exact) const; // ошибка в единицах последнего разряда
+
+
+	Dual EvaluateOperator(const string& op, const Dual& arg1, const Dual& arg2) const; // вычисление операции над дуальными числами
+	Dual EvaluateOperator(Operation op, const Dual& arg1, const Dual& arg2) const; // вычисление операции над дуальными числами по её коду
+	Dual ApplyNative(const NativeFunction& native, const Dual *args) const; // вычисление встроенной функции от дуальных чисел в радианах
+	Dual EvaluateFunctional(const string& name, const Function& function, const Dual& arg1, const Dual& arg2) const; // вычисление оператора над функцией от дуальных чисел
+
+	Rational EvaluateOperator(const string& op, const Rational& arg1, const Rational& arg2) const; // вычисление операции над дробями
+	Rational EvaluateNative(const NativeFunction& native, const Rational *args) const; // вычисление встроенной функции от дробей
+	BigFloat EvaluateOperator(const string& op, const BigFloat& arg1, const BigFloat& arg2) const; // вычисление операции над длинными числами
+	BigFloat EvaluateNative(const NativeFunction& native, const BigFloat *args) const; // вычисление встроенной функции от длинных чисел
+	template <typename T>
+	T EvaluateFunctional(const string& name, const Function& function, const T& arg1, const T& arg2) const; // вычисление оператора над функцией в точной арифметике
+
+	template <typename T>
+	T ParseValue(const string& token) const; // получение значения числа или константы
+	template <typename T>
+	T EvaluateVariable(const Variable& variable) const; // получение значения переменной
+	template <typename T>
+	T EvaluateUserFunction(const Function& function, const T& arg) const; // вычисление пользовательской функции
+	template <typename T>
+	T Evaluate(const vector<string>& rpn, const string& arg = "", const T& value = T()) const; // вычисление выражения, записанного в ПОЛИЗе
+
+	vector<Accuracy> MeasureAccuracy() const; // оценка ошибки встроенных функций относительно стандартной библиотеки
+	double AccuracyBound(const string& name) const; // допустимая ошибка встроенной функции в текущей точности
+
+	friend class Checker; // перекрёстная проверка вызывает вычислители напрямую
 
 public:
-	Calculator(bool degrees); // конструткор из режима тригонометрии
+	Calculator(bool degrees, Precision precision = Precision::Strict, Arithmetic arithmetic = Arithmetic::Double); // конструткор из режима тригонометрии, точности функций и арифметики
 
 	void Calculate(const string& command);
+	void RegisterFunction(const string& name, size_t arity, NativeKernel kernel, bool pure = true, NativeBatchKernel batch = nullptr); // регистрация встроенной функции
+	void EvaluateBatch(const string& name, const double *args, double *results, size_t count) const; // вычисление пользовательской функции для массива аргументов
+	double Differentiate(const string& name, double x, double& derivative) const; // значение и производная пользовательской функции в точке
 	void Reset(); // сброс информации о переменных и функциях
 	
 	void PrintState() const; // вывод состояния калькулятора
 	void PrintHelp() const; // вывод сообщений о работе калькулятора
+	void PrintAccuracy() const; // вывод ошибки встроенных функций относительно стандартной библиотеки
 };
 
-Calculator::Calculator(bool degrees) {
+Calculator::Calculator(bool degrees, Precision precision, Arithmetic arithmetic) {
 	this->degrees = degrees; // запоминаем режим
+	this->precision = precision;
+	this->arithmetic = arithmetic;
+	this->treeBudget = DIFF_LIMIT;
+
+	RegisterBuiltins();
 }
 
 // разбивка строки с командой на лексемы
@@ -173,6 +402,20 @@ bool Calculator::IsNumber(const string& s) const {
 	return true; // иначе число
 }
 
+// получение значения числа в двойной точности, слишком большие числа - ошибка калькулятора, а не исключение библиотеки
+double Calculator::ParseNumber(const string& s) const {
+	char *end;
+	double value = strtod(s.c_str(), &end);
+
+	if (s.length() == 0 || *end != '\0')
+		throw string("incorrect number '") + s + "'";
+
+	if (isinf(value))
+		throw string("number '") + s + "' is too large";
+
+	return value; // слишком маленькие числа округляются до нуля
+}
+
 // проверка на константу
 bool Calculator::IsConstant(const string& s) const {
 	for (size_t i = 0; i < constants.size(); i++)
@@ -185,7 +428,7 @@ bool Calculator::IsConstant(const string& s) const {
 // проверка на идентификатор (переменную)
 bool Calculator::IsIdentifier(const string& s) const {
 	// если это ключевое слово
-	if (s == DEF || s == SET)
+	if (s == DEF || s == SET || s == DIFF || s == DOUBLE || s == EXACT || s == PRECISE)
 		return false; // то это не переменная
 
 	// если первый символ не буква
@@ -205,6 +448,29 @@ bool Calculator::IsOperator(const string& s) const {
 	return s == "+" || s == "-" || s == "*" || s == "/" || s == "mod" || s == "^";
 }
 
+// получение кода операции по её имени
+Calculator::Operation Calculator::GetOperation(const string& op) const {
+	if (op == "+")
+		return Operation::Add;
+
+	if (op == "-")
+		return Operation::Subtract;
+
+	if (op == "*")
+		return Operation::Multiply;
+
+	if (op == "/")
+		return Operation::Divide;
+
+	if (op == "mod")
+		return Operation::Mod;
+
+	if (op == "^")
+		return Operation::Power;
+
+	throw string("unhandled operator '") + op + "'";
+}
+
 // проверка на пользовательскую переменную
 bool Calculator::IsUserVariable(const string& s) const {
 	for (size_t i = 0; i < userVariables.size(); i++)
@@ -223,19 +489,15 @@ bool Calculator::IsUserFunction(const string& s) const {
 	return false;
 }
 
-// проверка на функцию одного аргумента
-bool Calculator::IsFunction(const string& s) const {
-	for (size_t i = 0; i < functions.size(); i++)
-		if (functions[i] == s)
-			return true;
-
-	return false;
+// проверка на встроенную функцию
+bool Calculator::IsNative(const string& s) const {
+	return nativeIndices.find(s) != nativeIndices.end();
 }
 
-// проверка на функцию двух аргументов
-bool Calculator::IsBinaryFunction(const string& s) const {
-	for (size_t i = 0; i < functionsBinary.size(); i++)
-		if (functionsBinary[i] == s)
+// проверка на оператор над пользовательской функцией
+bool Calculator::IsFunctional(const string& s) const {
+	for (size_t i = 0; i < functionals.size(); i++)
+		if (functionals[i] == s)
 			return true;
 
 	return false;
@@ -303,7 +565,35 @@ bool Calculator::Entity(bool isUnary, bool insertUnary) {
     	rpn.push_back(CurrLexeme()); // заносим её в полиз
     	NextLexeme();
     }
-    else if (IsFunction(CurrLexeme()) || IsUserFunction(CurrLexeme())) { // если функция
+    else if (IsFunctional(CurrLexeme())) { // если оператор над пользовательской функцией
+		string func = CurrLexeme();
+		NextLexeme();
+		CheckLexeme("(");
+		NextLexeme();
+
+		string name = CurrLexeme(); // получаем имя функции
+
+		if (!IsUserFunction(name))
+			throw string("'") + name + "' is not a user function";
+
+		NextLexeme();
+		CheckLexeme(","); // проверяем на разделитель
+		NextLexeme();
+
+		Addition(); // парсим левую границу
+
+		CheckLexeme(","); // проверяем на разделитель
+		NextLexeme();
+
+		Addition(); // парсим правую границу
+
+		CheckLexeme(")");
+		NextLexeme();
+
+		rpn.push_back(func); // добавляем оператор в полиз
+		rpn.push_back(name); // и имя функции сразу за ним
+    }
+    else if (IsUserFunction(CurrLexeme())) { // если пользовательская функция
 		string func = CurrLexeme();
 		NextLexeme();
 		CheckLexeme("(");
@@ -315,18 +605,23 @@ bool Calculator::Entity(bool isUnary, bool insertUnary) {
 
 		rpn.push_back(func); // добавляем функцию в полиз
     }
-    else if (IsBinaryFunction(CurrLexeme())) {
+    else if (IsNative(CurrLexeme())) { // если встроенная функция
     	string func = CurrLexeme();
+    	size_t arity = GetNative(func).arity;
 
     	NextLexeme();
 		CheckLexeme("(");
 		NextLexeme();
-		Addition(); // парсим первый аргумент
 
-		CheckLexeme(","); // проверяем на разделитель
-		NextLexeme();
+		// парсим аргументы через запятую
+		for (size_t i = 0; i < arity; i++) {
+			if (i > 0) {
+				CheckLexeme(","); // проверяем на разделитель
+				NextLexeme();
+			}
 
-		Addition(); // парсим второй аргумент
+			Addition();
+		}
 
 		CheckLexeme(")");
 		NextLexeme();
@@ -360,7 +655,7 @@ void Calculator::ParseSet() {
 		throw string("'") + name + "' is not a variable identifier";
 
 	// если пытаемся добавить математическую функцию
-	if (IsFunction(name) || IsBinaryFunction(name))
+	if (IsNative(name) || IsFunctional(name))
 		throw string("function '") + name + "' is math function";
 
 	// если имя является константой, то бросаем исключение
@@ -386,7 +681,8 @@ void Calculator::ParseSet() {
 
 	Variable variable;
 	variable.name = name;
-	variable.value = Evaluate(rpn);
+	variable.value = Evaluate<double>(rpn);
+	variable.rpn = rpn;
 
 	userVariables.push_back(variable);
 }
@@ -396,18 +692,7 @@ void Calculator::ParseDef() {
 	NextLexeme();
 
 	string name = CurrLexeme(); // получаем имя функции
-
-	// если имя не является идентификатором, бросаем исключение
-	if (!IsIdentifier(name))
-		throw string("'") + name + "' is not a function identifier";
-
-	// если пытаемся добавить математическую функцию
-	if (IsFunction(name) || IsBinaryFunction(name))
-		throw string("function '") + name + "' is math function";
-
-	// если такая функция уже есть
-	if (GetFunction(name) != nullptr)
-		throw string("function '") + name + "' already exists"; // бросаем исключение
+	CheckFunctionName(name);
 
 	NextLexeme();
 
@@ -444,10 +729,72 @@ void Calculator::ParseDef() {
 	function.name = name;
 	function.arg = arg;
 	function.rpn = rpn;
+	function.program = Compile(rpn, arg);
+	function.pure = IsPure(function.program);
 
 	userFunctions.push_back(function); // добавляем функцию в вектор
 }
 
+// обработка дифференцирования функции
+void Calculator::ParseDiff() {
+	NextLexeme();
+
+	CheckLexeme("(");
+	NextLexeme();
+
+	string name = CurrLexeme(); // получаем имя функции
+	const Function *function = GetFunction(name);
+
+	if (function == nullptr)
+		throw string("'") + name + "' is not a user function";
+
+	NextLexeme();
+
+	CheckLexeme(")");
+	NextLexeme();
+
+	if (lexemes.size())
+		throw string("incorrect diff command");
+
+	Function derivative;
+
+	derivative.name = "d" + name; // производная получает имя исходной функции с префиксом d
+	derivative.arg = function->arg;
+
+	CheckFunctionName(derivative.name); // имя производной проверяется так же, как имя обычной функции
+
+	treeBudget = DIFF_LIMIT;
+
+	Node tree = BuildTree(function->rpn, function->arg, nullptr); // строим дерево функции
+	ToRpn(Simplify(Derivative(tree, function->arg)), derivative.rpn); // дифференцируем и упрощаем его
+
+	derivative.program = Compile(derivative.rpn, derivative.arg);
+	derivative.pure = IsPure(derivative.program);
+	userFunctions.push_back(derivative); // добавляем производную как обычную функцию
+
+	cout << derivative.name << "(" << derivative.arg << ") = ";
+
+	for (size_t i = 0; i < derivative.rpn.size(); i++)
+		cout << derivative.rpn[i] << " ";
+
+	cout << endl;
+}
+
+// проверка имени новой пользовательской функции: идентификатор, не занятый встроенной или пользовательской функцией
+void Calculator::CheckFunctionName(const string& name) const {
+	// если имя не является идентификатором, бросаем исключение
+	if (!IsIdentifier(name))
+		throw string("'") + name + "' is not a function identifier";
+
+	// если пытаемся добавить математическую функцию
+	if (IsNative(name) || IsFunctional(name))
+		throw string("function '") + name + "' is math function";
+
+	// если такая функция уже есть
+	if (GetFunction(name) != nullptr)
+		throw string("function '") + name + "' already exists"; // бросаем исключение
+}
+
 // получение указателя на переменную по её имени
 const Calculator::Variable* Calculator::GetVariable(const string& name) const {
 	for (size_t i = 0; i < userVariables.size(); i++)
@@ -466,199 +813,1544 @@ const Calculator::Function* Calculator::GetFunction(const string& name) const {
 	return nullptr; // иначе возвращаем nullptr
 }
 
-// получение значения константы
-double Calculator::EvaluateConstant(const string& constant) const {
-	if (constant == "pi")
-		return M_PI;
-
-	if (constant == "e")
-		return exp(1);
+// получение индекса функции по её имени
+size_t Calculator::GetFunctionIndex(const string& name) const {
+	for (size_t i = 0; i < userFunctions.size(); i++)
+		if (userFunctions[i].name == name) // если имена совпали
+			return i; // возвращаем индекс
 
-	throw string("unhandled constant '") + constant + "'";
+	throw string("unknown function '") + name + "'";
 }
 
-// вычисление значения операции
-double Calculator::EvaluateOperator(const string& op, double arg1, double arg2) const {
-	if (op == "+")
-		return arg1 + arg2;
+// получение встроенной функции по её имени
+const Calculator::NativeFunction& Calculator::GetNative(const string& name) const {
+	auto it = nativeIndices.find(name);
 
-	if (op == "-")
-		return arg1 - arg2;
+	if (it == nativeIndices.end())
+		throw string("unknown function '") + name + "'";
 
-	if (op == "*")
-		return arg1 * arg2;
+	return natives[it->second];
+}
 
-	if (op == "/") {
-		if (arg2 == 0)
-			throw string("division by zero");
+// регистрация встроенной функции: ядро получает массив из arity аргументов
+void Calculator::RegisterFunction(const string& name, size_t arity, NativeKernel kernel, bool pure, NativeBatchKernel batch) {
+	if (!IsIdentifier(name))
+		throw string("'") + name + "' is not a function identifier";
 
-		return arg1 / arg2;
-	}
+	// повторная регистрация запрещена: индексы, арность и свёрнутые значения уже скомпилированных функций стали бы неверными
+	if (IsOperator(name) || IsNative(name) || IsConstant(name) || IsFunctional(name) || IsUserFunction(name) || IsUserVariable(name))
+		throw string("name '") + name + "' is already used";
 
-	if (op == "^")
-		return pow(arg1, arg2);
+	if (kernel == nullptr)
+		throw string("function '") + name + "' has no kernel";
 
-	if (op == "mod")
-		return fmod(arg1, arg2);
+	nativeIndices[name] = natives.size();
+	natives.push_back({ name, arity, kernel, batch, pure, Angle::None, {}, false, Exact::None });
+}
 
-	throw string("unhandled operator '") + op + "'";
+// регистрация другого имени встроенной функции
+void Calculator::RegisterAlias(const string& alias, const string& name) {
+	NativeFunction native = GetNative(name);
+
+	native.name = alias;
+	nativeIndices[alias] = natives.size();
+	natives.push_back(native);
 }
 
-// вычисление значения функции
-double Calculator::EvaluateFunction(const string& name, double arg) const {
-	if (name == "sin")
-		return sin(degrees ? M_PI / 180 * arg : arg);
-	
-	if (name == "cos")
-		return cos(degrees ? M_PI / 180 * arg : arg);
-	
-	if (name == "tan" || name == "tg")
-		return tan(degrees ? M_PI / 180 * arg : arg);
-	
-	if (name == "cot" || name == "ctg")
-		return 1.0  / tan(degrees ? M_PI / 180 * arg : arg);
+// задание перевода градусов и частных производных встроенной функции
+void Calculator::SetDerivatives(const string& name, Angle angle, const vector<NativeKernel>& partials) {
+	NativeFunction& native = natives[nativeIndices.at(name)];
 
-	if (name == "asin" || name == "arcsin")
-		return degrees ? asin(arg) * 180 / M_PI : asin(arg);
-	
-	if (name == "acos" || name == "arccos")
-		return degrees ? acos(arg) * 180 / M_PI : acos(arg);
+	native.angle = angle;
+	native.partials = partials;
+}
 
-	if (name == "atan" || name == "arctan" || name == "arctg")
-		return degrees ? atan(arg) * 180 / M_PI : atan(arg);
+// регистрация встроенных функций, ядра выбираются по точности калькулятора
+void Calculator::RegisterBuiltins() {
+	if (precision == Precision::Float) {
+		RegisterFunction("sin", 1, [](const double *x) -> double { return sinf(x[0]); });
+		RegisterFunction("cos", 1, [](const double *x) -> double { return cosf(x[0]); });
+		RegisterFunction("tan", 1, [](const double *x) -> double { return tanf(x[0]); });
+		RegisterFunction("cot", 1, [](const double *x) -> double { return 1.0f / tanf(x[0]); });
+		RegisterFunction("asin", 1, [](const double *x) -> double { return asinf(x[0]); });
+		RegisterFunction("acos", 1, [](const double *x) -> double { return acosf(x[0]); });
+		RegisterFunction("atan", 1, [](const double *x) -> double { return atanf(x[0]); });
+		RegisterFunction("sqrt", 1, [](const double *x) -> double { return sqrtf(x[0]); });
+		RegisterFunction("ln", 1, [](const double *x) -> double { return logf(x[0]); });
+		RegisterFunction("lg", 1, [](const double *x) -> double { return log10f(x[0]); });
+		RegisterFunction("exp", 1, [](const double *x) -> double { return expf(x[0]); });
+		RegisterFunction("pow", 2, [](const double *x) -> double { return powf(x[0], x[1]); });
+		RegisterFunction("log", 2, [](const double *x) -> double { return logf(x[1]) / logf(x[0]); });
+
+		for (size_t i = 0; i < natives.size(); i++)
+			natives[i].single = true;
+	}
+	else if (precision == Precision::Fast) {
+		RegisterFunction("sin", 1, [](const double *x) { return FastSin(x[0]); }, true, [](const double *x, double *y, size_t n) {
+			for (size_t i = 0; i < n; i++)
+				y[i] = FastSin(x[i]);
+		});
+
+		RegisterFunction("cos", 1, [](const double *x) { return FastCos(x[0]); }, true, [](const double *x, double *y, size_t n) {
+			for (size_t i = 0; i < n; i++)
+				y[i] = FastCos(x[i]);
+		});
+
+		RegisterFunction("tan", 1, [](const double *x) { return FastTan(x[0]); });
+		RegisterFunction("cot", 1, [](const double *x) { return 1.0 / FastTan(x[0]); });
+	}
+	else {
+		RegisterFunction("sin", 1, [](const double *x) { return sin(x[0]); });
+		RegisterFunction("cos", 1, [](const double *x) { return cos(x[0]); });
+		RegisterFunction("tan", 1, [](const double *x) { return tan(x[0]); });
+		RegisterFunction("cot", 1, [](const double *x) { return 1.0 / tan(x[0]); });
+	}
 
-	if (name == "sqrt")
-		return sqrt(arg);
-	
-	if (name == "lg")
-		return log10(arg);
-	
-	if (name == "ln")
-		return log(arg);
-	
-	if (name == "exp")
-		return exp(arg);
-	
-	if (name == "abs")
-		return fabs(arg);
+	// функции, не зависящие от точности (в одинарной точности уже зарегистрированы)
+	// табличные exp и log стандартной библиотеки быстрее полиномиальных приближений, поэтому используются и в быстрой точности
+	if (precision != Precision::Float) {
+		RegisterFunction("ln", 1, [](const double *x) { return log(x[0]); });
+		RegisterFunction("lg", 1, [](const double *x) { return log10(x[0]); });
+		RegisterFunction("exp", 1, [](const double *x) { return exp(x[0]); });
+		RegisterFunction("pow", 2, [](const double *x) { return pow(x[0], x[1]); });
+		RegisterFunction("log", 2, [](const double *x) { return log(x[1]) / log(x[0]); }); // log_a(b) = ln(b) / ln(a)
+		RegisterFunction("asin", 1, [](const double *x) { return asin(x[0]); });
+		RegisterFunction("acos", 1, [](const double *x) { return acos(x[0]); });
+		RegisterFunction("atan", 1, [](const double *x) { return atan(x[0]); });
+		RegisterFunction("sqrt", 1, [](const double *x) { return sqrt(x[0]); }, true, [](const double *x, double *y, size_t n) {
+			for (size_t i = 0; i < n; i++)
+				y[i] = sqrt(x[i]);
+		});
+	}
 
-	if (name == "sign")
-		return arg > 0 ? 1 : arg < 0 ? -1 : 0;
+	RegisterFunction("abs", 1, [](const double *x) { return fabs(x[0]); }, true, [](const double *x, double *y, size_t n) {
+		for (size_t i = 0; i < n; i++)
+			y[i] = fabs(x[i]);
+	});
+
+	RegisterFunction("sign", 1, [](const double *x) -> double { return x[0] > 0 ? 1 : x[0] < 0 ? -1 : 0; });
+	RegisterFunction("min", 2, [](const double *x) { return x[0] < x[1] ? x[0] : x[1]; });
+	RegisterFunction("max", 2, [](const double *x) { return x[0] > x[1] ? x[0] : x[1]; });
+
+	// частные производные вычисляются от аргумента в радианах
+	SetDerivatives("sin", Angle::Argument, { [](const double *x) { return cos(x[0]); } });
+	SetDerivatives("cos", Angle::Argument, { [](const double *x) { return -sin(x[0]); } });
+	SetDerivatives("tan", Angle::Argument, { [](const double *x) { return 1 / (cos(x[0]) * cos(x[0])); } });
+	SetDerivatives("cot", Angle::Argument, { [](const double *x) { return -1 / (sin(x[0]) * sin(x[0])); } });
+	SetDerivatives("asin", Angle::Result, { [](const double *x) { return 1 / sqrt(1 - x[0] * x[0]); } });
+	SetDerivatives("acos", Angle::Result, { [](const double *x) { return -1 / sqrt(1 - x[0] * x[0]); } });
+	SetDerivatives("atan", Angle::Result, { [](const double *x) { return 1 / (1 + x[0] * x[0]); } });
+	SetDerivatives("sqrt", Angle::None, { [](const double *x) { return 0.5 / sqrt(x[0]); } });
+	SetDerivatives("ln", Angle::None, { [](const double *x) { return 1 / x[0]; } });
+	SetDerivatives("lg", Angle::None, { [](const double *x) { return 1 / (x[0] * log(10)); } });
+	SetDerivatives("exp", Angle::None, { [](const double *x) { return exp(x[0]); } });
+	SetDerivatives("abs", Angle::None, { [](const double *x) -> double { return x[0] > 0 ? 1 : x[0] < 0 ? -1 : 0; } });
+	SetDerivatives("sign", Angle::None, { [](const double *x) { return 0.0; } });
+
+	SetDerivatives("pow", Angle::None, {
+		[](const double *x) { return x[1] * pow(x[0], x[1] - 1); },
+		[](const double *x) { return pow(x[0], x[1]) * log(x[0]); }
+	});
+
+	SetDerivatives("log", Angle::None, { // log_a(b) = ln(b) / ln(a)
+		[](const double *x) { return -log(x[1]) / (x[0] * log(x[0]) * log(x[0])); },
+		[](const double *x) { return 1 / (x[1] * log(x[0])); }
+	});
+
+	SetDerivatives("min", Angle::None, {
+		[](const double *x) -> double { return x[0] < x[1] ? 1 : 0; },
+		[](const double *x) -> double { return x[0] < x[1] ? 0 : 1; }
+	});
+
+	SetDerivatives("max", Angle::None, {
+		[](const double *x) -> double { return x[0] > x[1] ? 1 : 0; },
+		[](const double *x) -> double { return x[0] > x[1] ? 0 : 1; }
+	});
+
+	// функции, вычисляемые в точной и длинной арифметике, отмечаются при регистрации, чтобы не сравнивать имена при каждом вызове
+	const vector<pair<string, Exact>> exact = {
+		{ "abs", Exact::Abs }, { "sign", Exact::Sign }, { "min", Exact::Min }, { "max", Exact::Max }, { "pow", Exact::Pow }, { "sqrt", Exact::Sqrt }
+	};
 
-	throw string("unhandled function '") + name + "'";
-}
+	for (size_t i = 0; i < exact.size(); i++)
+		natives[nativeIndices.at(exact[i].first)].exact = exact[i].second;
 
-// вычисление значения бинарной функции
-double Calculator::EvaluateBinaryfunction(const string& name, double arg1, double arg2) const {
-	if (name == "pow")
-		return pow(arg1, arg2);
-	
-	if (name == "min")
-		return arg1 < arg2 ? arg1 : arg2;
-	
-	if (name == "max")
-		return arg1 > arg2 ? arg1 : arg2;
-	
-	if (name == "log")
-		return log(arg2) / log(arg1); // log_a(b) = ln(b) / ln(a)
-	
-	throw string("unhandled function '") + name + "'";
+	RegisterAlias("tg", "tan");
+	RegisterAlias("ctg", "cot");
+	RegisterAlias("arcsin", "asin");
+	RegisterAlias("arccos", "acos");
+	RegisterAlias("arctan", "atan");
+	RegisterAlias("arctg", "atan");
+
+	powIndex = nativeIndices.at("pow");
 }
 
-// вычисление выражения, записанного в ПОЛИЗе
-double Calculator::Evaluate(const vector<string>& rpn) const {
-	stack<double> stack;
+// компиляция полиза функции в последовательность инструкций
+vector<Calculator::Instruction> Calculator::Compile(const vector<string>& rpn, const string& arg) const {
+	vector<Instruction> program;
 
 	for (size_t i = 0; i < rpn.size(); i++) {
-		if (IsOperator(rpn[i])) {
-			if (stack.size() < 2)
-				throw string("unable to take arguments for operator '") + rpn[i] + "': stack size is too small";
+		Instruction instruction = { OpCode::Number, rpn[i], 0, 0, Operation::Add };
 
-			// получаем аргументы из стека
-			double arg2 = stack.top();
-			stack.pop();
-			double arg1 = stack.top();
-			stack.pop();
-
-			stack.push(EvaluateOperator(rpn[i], arg1, arg2));
+		if (rpn[i] == arg) { // если аргумент функции
+			instruction.code = OpCode::Argument;
+		}
+		else if (IsOperator(rpn[i])) {
+			instruction.code = OpCode::Operator;
+			instruction.operation = GetOperation(rpn[i]);
 		}
 		else if (rpn[i] == "!") { // если унарный минус
-			stack.top() *= -1; // меняем знак у числа на верхушке стека
+			instruction.code = OpCode::Negate;
 		}
-		else if (IsFunction(rpn[i])) {
-			if (stack.size() == 0)
-				throw string("unable to take arguments for function '") + rpn[i] + "': stack size is too small";
+		else if (IsNative(rpn[i])) {
+			instruction.code = OpCode::Native;
+			instruction.index = nativeIndices.at(rpn[i]);
 
-			double arg = stack.top();
-			stack.pop();
+			Angle angle = natives[instruction.index].angle;
 
-			stack.push(EvaluateFunction(rpn[i], arg));
+			// перевод градусов выполняется отдельной инструкцией, а функция вычисляется в радианах
+			if (degrees && angle == Angle::Argument) {
+				program.push_back({ OpCode::Scale, "", M_PI / 180, 0, Operation::Add });
+				Fold(program);
+			}
+			else if (degrees && angle == Angle::Result) {
+				program.push_back(instruction);
+				Fold(program);
+				instruction = { OpCode::Scale, "", 180 / M_PI, 0, Operation::Add };
+			}
+		}
+		else if (IsFunctional(rpn[i])) { // если оператор, то за ним следует имя функции
+			instruction.code = OpCode::Functional;
+			instruction.index = GetFunctionIndex(rpn[++i]);
+		}
+		else if (IsUserFunction(rpn[i])) {
+			instruction.code = OpCode::UserFunction;
+			instruction.index = GetFunctionIndex(rpn[i]);
+		}
+		else if (IsConstant(rpn[i])) { // если константа, то сразу вычисляем её значение
+			instruction.value = EvaluateConstant(rpn[i]);
+		}
+		else { // иначе число
+			instruction.value = ParseNumber(rpn[i]);
 		}
-		else if (IsBinaryFunction(rpn[i])) {
-			if (stack.size() < 2)
-				throw string("unable to take arguments for function '") + rpn[i] + "': stack size is too small";
 
-			// получаем аргументы из стека
-			double arg2 = stack.top();
-			stack.pop();
-			double arg1 = stack.top();
-			stack.pop();
+		program.push_back(instruction);
+		Fold(program);
+	}
 
-			stack.push(EvaluateBinaryfunction(rpn[i], arg1, arg2));
-		}
-		else if (IsUserVariable(rpn[i])) { // если переменная
-			const Variable *variable = GetVariable(rpn[i]); // получаем значение переменной по её имени
+	return program;
+}
 
-			if (variable == nullptr)
-				throw string("unknown variable '") + rpn[i] + "'";
+// свёртка последней инструкции программы, если все её аргументы - числа, а результат не зависит от состояния
+void Calculator::Fold(vector<Instruction>& program) const {
+	Instruction& instruction = program.back();
+	size_t arity = 0; // количество аргументов инструкции
 
-			stack.push(variable->value); // и добавляем его в стек
-		}
-		else if (IsUserFunction(rpn[i])) {
-			const Function *function = GetFunction(rpn[i]);
+	switch (instruction.code) {
+		case OpCode::Negate:
+		case OpCode::Scale:
+			arity = 1;
+			break;
 
-			if (function == nullptr)
-				throw string("unknown function '") + rpn[i] + "'";
+		case OpCode::Operator:
+			arity = 2;
+			break;
 
-			if (stack.size() == 0)
-				throw string("unable to take arguments for function '") + rpn[i] + "': stack size is too small";
+		case OpCode::Native:
+			if (!natives[instruction.index].pure)
+				return;
 
-			double arg = stack.top(); // получаем аргумент функции
+			arity = natives[instruction.index].arity;
+			break;
 
-			stack.pop();
+		case OpCode::UserFunction:
+			if (!userFunctions[instruction.index].pure)
+				return;
+
+			arity = 1;
+			break;
+
+		case OpCode::Functional:
+			if (!userFunctions[instruction.index].pure)
+				return;
+
+			arity = 2;
+			break;
+
+		default:
+			return;
+	}
+
+	if (program.size() < arity + 1)
+		return;
+
+	vector<double> args;
 
-			vector<string> tmp = function->rpn;
+	for (size_t i = program.size() - 1 - arity; i < program.size() - 1; i++) {
+		if (program[i].code != OpCode::Number)
+			return;
 
-			// заменяем аргумент функции на число
-			for (size_t j = 0; j < tmp.size(); j++)
-				if (tmp[j] == function->arg)
-					tmp[j] = to_string(arg);
+		args.push_back(program[i].value);
+	}
+
+	double value;
 
-			stack.push(Evaluate(tmp)); // закидываем результат вычисления функции
+	try {
+		if (instruction.code == OpCode::Negate) {
+			value = -args[0];
+		}
+		else if (instruction.code == OpCode::Scale) {
+			value = args[0] * instruction.value;
+		}
+		else if (instruction.code == OpCode::Operator) {
+			value = EvaluateOperator(instruction.operation, args[0], args[1]);
 		}
-		else if (IsConstant(rpn[i])) { // если константа
-			stack.push(EvaluateConstant(rpn[i])); // кладём в стек её значение
+		else if (instruction.code == OpCode::Native) {
+			value = ApplyNative(natives[instruction.index], args.data());
 		}
-		else { // число, кидаем его в стек
-			stack.push(stod(rpn[i])); // то кидаем его в стек
+		else if (instruction.code == OpCode::UserFunction) {
+			vector<double> frame;
+			value = Execute(userFunctions[instruction.index].program, args[0], frame);
+		}
+		else {
+			value = EvaluateFunctional(instruction.name, userFunctions[instruction.index], args[0], args[1]);
 		}
 	}
+	catch (string) { // ошибка будет получена при вычислении
+		return;
+	}
 
-	if (stack.size() != 1)
-		throw string("error during computation expression");
-
-	return stack.top();
+	program.resize(program.size() - arity);
+	program.back() = { OpCode::Number, "", value, 0, Operation::Add };
 }
 
-// выполнение команды
-void Calculator::Calculate(const string& command) {
-	lexemes.clear();
-	rpn.clear();
+// проверка, что результат функции зависит только от аргумента
+bool Calculator::IsPure(const vector<Instruction>& program) const {
+	for (size_t i = 0; i < program.size(); i++) {
+		if (program[i].code == OpCode::Native && !natives[program[i].index].pure)
+			return false;
 
-	SplitToLexemes(command);
+		if ((program[i].code == OpCode::UserFunction || program[i].code == OpCode::Functional) && !userFunctions[program[i].index].pure)
+			return false;
+	}
 
-	if (lexemes.size() == 0)
-		throw string("Command is invalid");
+	return true;
+}
+
+// выполнение скомпилированной функции, промежуточные значения хранятся в общем кадре frame
+template <typename T>
+T Calculator::Execute(const vector<Instruction>& program, T arg, vector<T>& frame) const {
+	size_t base = frame.size(); // начало значений текущего вызова в кадре
+
+	for (size_t i = 0; i < program.size(); i++) {
+		const Instruction& instruction = program[i];
+
+		switch (instruction.code) {
+			case OpCode::Number:
+				frame.push_back(T(instruction.value));
+				break;
+
+			case OpCode::Argument:
+				frame.push_back(arg);
+				break;
+
+			case OpCode::Negate:
+				frame.back() = -frame.back();
+				break;
+
+			case OpCode::Scale:
+				frame.back() = frame.back() * instruction.value;
+				break;
+
+			case OpCode::Operator: {
+				T arg2 = frame.back();
+				frame.pop_back();
+				frame.back() = EvaluateOperator(instruction.operation, frame.back(), arg2);
+				break;
+			}
+
+			case OpCode::Native: {
+				// аргументы функции лежат в конце кадра подряд
+				size_t start = frame.size() - natives[instruction.index].arity;
+				T value = ApplyNative(natives[instruction.index], frame.data() + start);
+				frame.resize(start);
+				frame.push_back(value);
+				break;
+			}
+
+			case OpCode::UserFunction: {
+				// вложенный вызов использует тот же кадр поверх текущих значений
+				T value = Execute(userFunctions[instruction.index].program, frame.back(), frame);
+				frame.back() = value;
+				break;
+			}
+
+			case OpCode::Functional: {
+				T arg2 = frame.back();
+				frame.pop_back();
+				T value = EvaluateFunctional(instruction.name, userFunctions[instruction.index], frame.back(), arg2);
+				frame.back() = value;
+				break;
+			}
+		}
+	}
+
+	if (frame.size() != base + 1)
+		throw string("error during computation expression");
+
+	T result = frame.back();
+	frame.resize(base); // освобождаем кадр для следующего вызова
+
+	return result;
+}
+
+// выполнение скомпилированной функции сразу для count значений аргумента, промежуточные значения хранятся в кадре столбцами по count чисел
+void Calculator::ExecuteBatch(const vector<Instruction>& program, const double *args, double *results, size_t count, vector<double>& frame) const {
+	size_t base = frame.size(); // начало значений текущего вызова в кадре
+	vector<double> column(count); // столбец для результатов функций
+
+	for (size_t i = 0; i < program.size(); i++) {
+		const Instruction& instruction = program[i];
+
+		// верхний столбец кадра вычисляется только там, где он используется, так как кадр может быть ещё короче count
+		switch (instruction.code) {
+			case OpCode::Number:
+				frame.insert(frame.end(), count, instruction.value);
+				break;
+
+			case OpCode::Argument:
+				frame.insert(frame.end(), args, args + count);
+				break;
+
+			case OpCode::Negate: {
+				double *top = frame.data() + frame.size() - count;
+
+				for (size_t k = 0; k < count; k++)
+					top[k] = -top[k];
+
+				break;
+			}
+
+			case OpCode::Scale: {
+				double *top = frame.data() + frame.size() - count;
+
+				for (size_t k = 0; k < count; k++)
+					top[k] *= instruction.value;
+
+				break;
+			}
+
+			case OpCode::Operator: {
+				double *top = frame.data() + frame.size() - count;
+
+				EvaluateOperatorBatch(instruction.operation, top - count, top, count);
+				frame.resize(frame.size() - count);
+				break;
+			}
+
+			case OpCode::Native: {
+				const NativeFunction& native = natives[instruction.index];
+				size_t start = frame.size() - native.arity * count; // аргументы функции лежат в последних столбцах
+
+				if (native.batch != nullptr) {
+					native.batch(frame.data() + start, column.data(), count);
+				}
+				else {
+					vector<double> lane(native.arity); // аргументы одной точки
+
+					for (size_t k = 0; k < count; k++) {
+						for (size_t j = 0; j < native.arity; j++)
+							lane[j] = frame[start + j * count + k];
+
+						column[k] = native.kernel(lane.data());
+					}
+				}
+
+				frame.resize(start);
+				frame.insert(frame.end(), column.begin(), column.end());
+				break;
+			}
+
+			case OpCode::UserFunction:
+				column.assign(frame.end() - count, frame.end());
+				frame.resize(frame.size() - count);
+				ExecuteBatch(userFunctions[instruction.index].program, column.data(), column.data(), count, frame);
+				frame.insert(frame.end(), column.begin(), column.end());
+				break;
+
+			case OpCode::Functional: {
+				double *top = frame.data() + frame.size() - count;
+
+				for (size_t k = 0; k < count; k++)
+					column[k] = EvaluateFunctional(instruction.name, userFunctions[instruction.index], (top - count)[k], top[k]);
+
+				frame.resize(frame.size() - 2 * count);
+				frame.insert(frame.end(), column.begin(), column.end());
+				break;
+			}
+		}
+	}
+
+	if (frame.size() != base + count)
+		throw string("error during computation expression");
+
+	copy(frame.begin() + base, frame.end(), results);
+	frame.resize(base); // освобождаем кадр для следующего вызова
+}
+
+// вычисление операции над массивами, результат записывается в arg1
+void Calculator::EvaluateOperatorBatch(Operation op, double *arg1, const double *arg2, size_t count) const {
+	if (op == Operation::Add) {
+		for (size_t k = 0; k < count; k++)
+			arg1[k] += arg2[k];
+	}
+	else if (op == Operation::Subtract) {
+		for (size_t k = 0; k < count; k++)
+			arg1[k] -= arg2[k];
+	}
+	else if (op == Operation::Multiply) {
+		for (size_t k = 0; k < count; k++)
+			arg1[k] *= arg2[k];
+	}
+	else {
+		for (size_t k = 0; k < count; k++)
+			arg1[k] = EvaluateOperator(op, arg1[k], arg2[k]);
+	}
+}
+
+// численное интегрирование функции адаптивным методом Симпсона, отрезок делится на панели по числу потоков общего пула
+double Calculator::Integrate(const Function& function, double a, double b) const {
+	ThreadPool& pool = ThreadPool::Shared();
+	size_t panels = pool.Size();
+	double h = (b - a) / panels; // ширина одной панели
+	double eps = INTEGRATION_EPS / panels;
+
+	// интегрирование одной панели, у каждой панели свой кадр вычислений
+	auto panel = [this, &function, a, b, h, panels, eps](size_t i) {
+		double left = a + h * i;
+		double right = i == panels - 1 ? b : a + h * (i + 1);
+		vector<double> frame;
+
+		double fa = Execute(function.program, left, frame);
+		double fm = Execute(function.program, (left + right) / 2, frame);
+		double fb = Execute(function.program, right, frame);
+		double whole = (right - left) / 6 * (fa + 4 * fm + fb);
+
+		return IntegratePanel(function, left, right, fa, fm, fb, whole, eps, INTEGRATION_DEPTH, frame);
+	};
+
+	double result = 0;
+
+	// вложенное интегрирование уже выполняется в потоке пула, поэтому панели считаются последовательно
+	if (ThreadPool::IsWorker()) {
+		for (size_t i = 0; i < panels; i++)
+			result += panel(i);
+
+		return result;
+	}
+
+	vector<future<double>> parts;
+
+	for (size_t i = 0; i < panels; i++)
+		parts.push_back(pool.Submit(bind(panel, i)));
+
+	// дожидаемся всех панелей до проброса исключения, так как задачи ссылаются на функцию
+	for (size_t i = 0; i < parts.size(); i++)
+		parts[i].wait();
+
+	for (size_t i = 0; i < parts.size(); i++)
+		result += parts[i].get(); // get пробрасывает исключения из потока
+
+	return result;
+}
+
+// адаптивный метод Симпсона на отрезке [a, b] с известными значениями на концах и в середине
+double Calculator::IntegratePanel(const Function& function, double a, double b, double fa, double fm, double fb, double whole, double eps, int depth, vector<double>& frame) const {
+	double m = (a + b) / 2;
+	double flm = Execute(function.program, (a + m) / 2, frame);
+	double frm = Execute(function.program, (m + b) / 2, frame);
+
+	double left = (m - a) / 6 * (fa + 4 * flm + fm);
+	double right = (b - m) / 6 * (fm + 4 * frm + fb);
+	double delta = left + right - whole;
+
+	// если достигли нужной точности, предела разбиения или значение не конечно
+	if (depth <= 0 || fabs(delta) <= 15 * eps || !isfinite(delta))
+		return left + right + delta / 15;
+
+	return IntegratePanel(function, a, m, fa, flm, fm, left, eps / 2, depth - 1, frame) + IntegratePanel(function, m, b, fm, frm, fb, right, eps / 2, depth - 1, frame);
+}
+
+// поиск корня функции на отрезке методом ложного положения (модификация Иллинойс)
+double Calculator::Solve(const Function& function, double lo, double hi) const {
+	vector<double> frame;
+
+	double flo = Execute(function.program, lo, frame);
+	double fhi = Execute(function.program, hi, frame);
+
+	if (flo == 0)
+		return lo;
+
+	if (fhi == 0)
+		return hi;
+
+	if ((flo < 0) == (fhi < 0))
+		throw string("function '") + function.name + "' does not change sign on the segment";
+
+	int side = 0; // с какой стороны сдвигалась граница на прошлой итерации
+	double x = lo;
+
+	for (int i = 0; i < SOLVE_ITERATIONS; i++) {
+		x = (lo * fhi - hi * flo) / (fhi - flo);
+
+		// если секущая вышла за отрезок, делим его пополам
+		if (!(x > min(lo, hi) && x < max(lo, hi)))
+			x = (lo + hi) / 2;
+
+		double fx = Execute(function.program, x, frame);
+
+		if (isnan(fx))
+			throw string("function '") + function.name + "' is undefined at " + to_string(x);
+
+		if (fx == 0 || fabs(hi - lo) <= SOLVE_EPS * (1 + fabs(x)))
+			return x;
+
+		if ((fx < 0) == (fhi < 0)) {
+			hi = x;
+			fhi = fx;
+
+			if (side == -1)
+				flo /= 2;
+
+			side = -1;
+		}
+		else {
+			lo = x;
+			flo = fx;
+
+			if (side == 1)
+				fhi /= 2;
+
+			side = 1;
+		}
+	}
+
+	return x;
+}
+
+// количество слагаемых суммы по точкам a, a + 1, ..., не превосходящим b
+double Calculator::SumTerms(double a, double b) const {
+	if (!isfinite(a) || !isfinite(b))
+		throw string("bounds of sum must be finite");
+
+	double terms = b < a ? 0 : floor(b - a) + 1;
+
+	if (terms > SUM_LIMIT)
+		throw string("sum has too many terms");
+
+	return terms;
+}
+
+// сумма значений функции в точках a, a + 1, ..., не превосходящих b
+double Calculator::Sum(const Function& function, double a, double b) const {
+	vector<double> frame;
+	vector<double> points;
+	vector<double> values(SUM_BATCH);
+	double sum = 0;
+	double error = 0; // компенсация погрешности суммирования (метод Кэхэна)
+	double terms = SumTerms(a, b);
+
+	for (double i = 0; i < terms; ) {
+		points.clear();
+
+		// точки вычисляются пакетами, x = a + i не зависит от накопленной погрешности и меняется при больших a
+		for (; i < terms && points.size() < SUM_BATCH; i++)
+			points.push_back(a + i);
+
+		ExecuteBatch(function.program, points.data(), values.data(), points.size(), frame);
+
+		for (size_t i = 0; i < points.size(); i++) {
+			double y = values[i] - error;
+			double t = sum + y;
+			error = (t - sum) - y;
+			sum = t;
+		}
+	}
+
+	return sum;
+}
+
+// создание узла дерева выражения
+Calculator::Node Calculator::MakeNode(const string& token, const vector<Node>& args) const {
+	size_t size = 1;
+
+	for (size_t i = 0; i < args.size(); i++)
+		size += TreeSize(args[i]);
+
+	SpendNodes(size); // аргументы копируются в узел, поэтому учитываются целиком
+
+	Node node;
+
+	node.token = token;
+	node.args = args;
+
+	return node;
+}
+
+// количество узлов дерева выражения
+size_t Calculator::TreeSize(const Node& node) const {
+	size_t size = 1;
+
+	for (size_t i = 0; i < node.args.size(); i++)
+		size += TreeSize(node.args[i]);
+
+	return size;
+}
+
+// учёт созданных узлов: производные вложенных вызовов растут экспоненциально, поэтому их размер ограничен
+void Calculator::SpendNodes(size_t count) const {
+	if (count > treeBudget)
+		throw string("derivative is too large");
+
+	treeBudget -= count;
+}
+
+// создание узла с числом, отрицательные числа записываются через унарный минус
+Calculator::Node Calculator::MakeNumber(double value) const {
+	ostringstream stream;
+	stream << setprecision(17) << fabs(value);
+
+	Node node = MakeNode(stream.str());
+
+	return value < 0 ? MakeNode("!", { node }) : node;
+}
+
+// проверка, является ли узел числом (возможно, с унарным минусом)
+bool Calculator::IsValue(const Node& node, double& value) const {
+	if (node.args.size() == 0 && IsNumber(node.token)) {
+		value = ParseNumber(node.token);
+		return true;
+	}
+
+	if (node.token == "!" && node.args.size() == 1 && node.args[0].args.size() == 0 && IsNumber(node.args[0].token)) {
+		value = -ParseNumber(node.args[0].token);
+		return true;
+	}
+
+	return false;
+}
+
+// построение дерева выражения по полизу, аргумент arg заменяется на поддерево replacement, если оно задано
+Calculator::Node Calculator::BuildTree(const vector<string>& rpn, const string& arg, const Node *replacement) const {
+	vector<Node> stack;
+
+	for (size_t i = 0; i < rpn.size(); i++) {
+		Node node = MakeNode(rpn[i]);
+		size_t args = 0; // количество аргументов узла
+
+		if (rpn[i] == arg) { // если аргумент функции
+			if (replacement != nullptr) {
+				SpendNodes(TreeSize(*replacement));
+				node = *replacement;
+			}
+		}
+		else if (IsOperator(rpn[i])) {
+			args = 2;
+		}
+		else if (IsNative(rpn[i])) {
+			args = GetNative(rpn[i]).arity;
+		}
+		else if (rpn[i] == "!") {
+			args = 1;
+		}
+		else if (IsFunctional(rpn[i])) { // за оператором следует имя функции
+			node.function = rpn[++i];
+			args = 2;
+		}
+		else if (IsUserFunction(rpn[i])) {
+			args = 1;
+		}
+
+		if (stack.size() < args)
+			throw string("unable to take arguments for '") + node.token + "': stack size is too small";
+
+		node.args.insert(node.args.begin(), stack.end() - args, stack.end());
+		stack.resize(stack.size() - args);
+		stack.push_back(node);
+	}
+
+	if (stack.size() != 1)
+		throw string("error during building expression tree");
+
+	return stack[0];
+}
+
+// символьное дифференцирование дерева выражения по аргументу arg
+Calculator::Node Calculator::Derivative(const Node& node, const string& arg) const {
+	const string& name = node.token;
+
+	if (node.args.size() == 0) // производная аргумента равна 1, чисел и констант - 0
+		return MakeNode(name == arg ? "1" : "0");
+
+	if (name == "!")
+		return MakeNode("!", { Derivative(node.args[0], arg) });
+
+	// если оператор над функцией, то от границ зависит только интеграл: (F(b) - F(a))' = f(b)b' - f(a)a'
+	if (IsFunctional(name)) {
+		if (name != "integrate")
+			return MakeNode("0");
+
+		Node fa = MakeNode(node.function, { node.args[0] });
+		Node fb = MakeNode(node.function, { node.args[1] });
+
+		return MakeNode("-", { MakeNode("*", { fb, Derivative(node.args[1], arg) }), MakeNode("*", { fa, Derivative(node.args[0], arg) }) });
+	}
+
+	// если пользовательская функция, то подставляем аргумент в её тело и дифференцируем его
+	if (IsUserFunction(name)) {
+		const Function *function = GetFunction(name);
+
+		return Derivative(BuildTree(function->rpn, function->arg, &node.args[0]), arg);
+	}
+
+	const Node& u = node.args[0];
+	Node du = Derivative(u, arg);
+
+	Node k = degrees ? MakeNode("/", { MakeNode("pi"), MakeNode("180") }) : MakeNode("1"); // множитель для аргумента тригонометрических функций
+	Node r = degrees ? MakeNode("/", { MakeNode("180"), MakeNode("pi") }) : MakeNode("1"); // множитель для значения обратных тригонометрических функций
+
+	if (name == "sin")
+		return MakeNode("*", { MakeNode("*", { MakeNode("cos", { u }), k }), du });
+
+	if (name == "cos")
+		return MakeNode("!", { MakeNode("*", { MakeNode("*", { MakeNode("sin", { u }), k }), du }) });
+
+	if (name == "tan" || name == "tg")
+		return MakeNode("/", { MakeNode("*", { k, du }), MakeNode("^", { MakeNode("cos", { u }), MakeNode("2") }) });
+
+	if (name == "cot" || name == "ctg")
+		return MakeNode("!", { MakeNode("/", { MakeNode("*", { k, du }), MakeNode("^", { MakeNode("sin", { u }), MakeNode("2") }) }) });
+
+	if (name == "asin" || name == "arcsin" || name == "acos" || name == "arccos") {
+		Node d = MakeNode("/", { MakeNode("*", { r, du }), MakeNode("sqrt", { MakeNode("-", { MakeNode("1"), MakeNode("^", { u, MakeNode("2") }) }) }) });
+
+		return name == "asin" || name == "arcsin" ? d : MakeNode("!", { d });
+	}
+
+	if (name == "atan" || name == "arctan" || name == "arctg")
+		return MakeNode("/", { MakeNode("*", { r, du }), MakeNode("+", { MakeNode("1"), MakeNode("^", { u, MakeNode("2") }) }) });
+
+	if (name == "sqrt")
+		return MakeNode("/", { du, MakeNode("*", { MakeNode("2"), MakeNode("sqrt", { u }) }) });
+
+	if (name == "ln")
+		return MakeNode("/", { du, u });
+
+	if (name == "lg")
+		return MakeNode("/", { du, MakeNode("*", { u, MakeNode("ln", { MakeNode("10") }) }) });
+
+	if (name == "exp")
+		return MakeNode("*", { MakeNode("exp", { u }), du });
+
+	if (name == "abs")
+		return MakeNode("*", { MakeNode("sign", { u }), du });
+
+	if (name == "sign")
+		return MakeNode("0");
+
+	// ниже разбираются только функции двух аргументов, производные остальных встроенных функций неизвестны
+	if (node.args.size() != 2)
+		throw string("unable to differentiate '") + name + "'";
+
+	const Node& v = node.args[1];
+	Node dv = Derivative(v, arg);
+
+	if (name == "+" || name == "-")
+		return MakeNode(name, { du, dv });
+
+	if (name == "*")
+		return MakeNode("+", { MakeNode("*", { du, v }), MakeNode("*", { u, dv }) });
+
+	if (name == "/")
+		return MakeNode("/", { MakeNode("-", { MakeNode("*", { du, v }), MakeNode("*", { u, dv }) }), MakeNode("^", { v, MakeNode("2") }) });
+
+	if (name == "mod") // u mod v = u - trunc(u / v) * v, trunc(u / v) = (u - u mod v) / v
+		return MakeNode("-", { du, MakeNode("*", { MakeNode("/", { MakeNode("-", { u, node }), v }), dv }) });
+
+	if (name == "^" || name == "pow") {
+		double value;
+
+		// если показатель не зависит от аргумента: (u^v)' = v * u^(v-1) * u'
+		if (IsValue(Simplify(dv), value) && value == 0)
+			return MakeNode("*", { MakeNode("*", { v, MakeNode("^", { u, MakeNode("-", { v, MakeNode("1") }) }) }), du });
+
+		// иначе (u^v)' = u^v * (v' * ln(u) + v * u' / u)
+		return MakeNode("*", { node, MakeNode("+", { MakeNode("*", { dv, MakeNode("ln", { u }) }), MakeNode("/", { MakeNode("*", { v, du }), u }) }) });
+	}
+
+	if (name == "log") // log_u(v) = ln(v) / ln(u)
+		return Derivative(MakeNode("/", { MakeNode("ln", { v }), MakeNode("ln", { u }) }), arg);
+
+	// min(u, v)' = ((1 + s) * u' + (1 - s) * v') / 2, s = sign(v - u), у max знак разности обратный;
+	// вне точки u = v один из множителей равен нулю, поэтому производные разного порядка не сокращаются, как в (u' + v' - |u - v|') / 2
+	if (name == "min" || name == "max") {
+		Node s = MakeNode("sign", { name == "min" ? MakeNode("-", { v, u }) : MakeNode("-", { u, v }) });
+		Node first = MakeNode("*", { MakeNode("+", { MakeNode("1"), s }), du });
+		Node second = MakeNode("*", { MakeNode("-", { MakeNode("1"), s }), dv });
+
+		return MakeNode("/", { MakeNode("+", { first, second }), MakeNode("2") });
+	}
+
+	throw string("unable to differentiate '") + name + "'";
+}
+
+// упрощение дерева выражения: свёртка чисел и удаление нейтральных элементов
+Calculator::Node Calculator::Simplify(const Node& node) const {
+	Node result = node;
+
+	for (size_t i = 0; i < result.args.size(); i++)
+		result.args[i] = Simplify(result.args[i]);
+
+	if (result.args.size() == 0 || IsUserFunction(result.token) || IsFunctional(result.token))
+		return result;
+
+	vector<double> values(result.args.size());
+	bool isValues = true; // являются ли все аргументы числами
+
+	for (size_t i = 0; i < result.args.size(); i++)
+		isValues = IsValue(result.args[i], values[i]) && isValues;
+
+	double a = values[0], b = values.size() > 1 ? values[1] : 0;
+	bool isA = IsValue(result.args[0], a);
+	bool isB = result.args.size() > 1 && IsValue(result.args[1], b);
+
+	if (result.token == "!") {
+		if (result.args[0].token == "!" && !isA) // двойной унарный минус
+			return result.args[0].args[0];
+
+		return isA ? MakeNumber(-a) : result;
+	}
+
+	// если все аргументы - числа, а функция зависит только от них, вычисляем значение
+	if (isValues && (IsOperator(result.token) || GetNative(result.token).pure)) {
+		try {
+			double value;
+
+			if (IsOperator(result.token))
+				value = EvaluateOperator(result.token, a, b);
+			else
+				value = EvaluateNative(GetNative(result.token), values.data());
+
+			Node number = MakeNumber(value);
+
+			// сворачиваем, только если результат конечен и записывается обычным числом
+			if (isfinite(value) && IsNumber(value < 0 ? number.args[0].token : number.token))
+				return number;
+		}
+		catch (string) {
+		}
+	}
+
+	const string& name = result.token;
+
+	if (name == "+") {
+		if (isA && a == 0)
+			return result.args[1];
+
+		if (isB && b == 0)
+			return result.args[0];
+	}
+	else if (name == "-") {
+		if (isB && b == 0)
+			return result.args[0];
+
+		if (isA && a == 0)
+			return Simplify(MakeNode("!", { result.args[1] }));
+	}
+	else if (name == "*") {
+		if ((isA && a == 0) || (isB && b == 0))
+			return MakeNode("0");
+
+		if (isA && a == 1)
+			return result.args[1];
+
+		if (isB && b == 1)
+			return result.args[0];
+	}
+	else if (name == "/") {
+		if (isA && a == 0)
+			return MakeNode("0");
+
+		if (isB && b == 1)
+			return result.args[0];
+	}
+	else if (name == "^" || name == "pow") {
+		if (isB && b == 0)
+			return MakeNode("1");
+
+		if (isB && b == 1)
+			return result.args[0];
+	}
+
+	return result;
+}
+
+// перевод дерева выражения в полиз
+void Calculator::ToRpn(const Node& node, vector<string>& rpn) const {
+	for (size_t i = 0; i < node.args.size(); i++)
+		ToRpn(node.args[i], rpn);
+
+	rpn.push_back(node.token);
+
+	if (IsFunctional(node.token) && node.args.size()) // за оператором над функцией следует имя функции
+		rpn.push_back(node.function);
+}
+
+// получение значения константы
+double Calculator::EvaluateConstant(const string& constant) const {
+	if (constant == "pi")
+		return M_PI;
+
+	if (constant == "e")
+		return M_E;
+
+	throw string("unhandled constant '") + constant + "'";
+}
+
+// вычисление значения операции
+double Calculator::EvaluateOperator(const string& op, double arg1, double arg2) const {
+	return EvaluateOperator(GetOperation(op), arg1, arg2);
+}
+
+// вычисление значения операции по её коду
+double Calculator::EvaluateOperator(Operation op, double arg1, double arg2) const {
+	switch (op) {
+		case Operation::Add:
+			return arg1 + arg2;
+
+		case Operation::Subtract:
+			return arg1 - arg2;
+
+		case Operation::Multiply:
+			return arg1 * arg2;
+
+		case Operation::Divide:
+			if (arg2 == 0)
+				throw string("division by zero");
+
+			return arg1 / arg2;
+
+		case Operation::Power: {
+			double args[2] = { arg1, arg2 };
+
+			return ApplyNative(natives[powIndex], args);
+		}
+
+		case Operation::Mod:
+			return fmod(arg1, arg2);
+	}
+
+	throw string("unhandled operator");
+}
+
+// вычисление встроенной функции с учётом режима тригонометрии
+double Calculator::EvaluateNative(const NativeFunction& native, const double *args) const {
+	if (degrees && native.angle == Angle::Argument) { // переводим первый аргумент в радианы
+		vector<double> radians(args, args + native.arity);
+		radians[0] *= M_PI / 180;
+
+		return ApplyNative(native, radians.data());
+	}
+
+	if (degrees && native.angle == Angle::Result) // тот же множитель, что и в инструкции Scale скомпилированной функции
+		return ApplyNative(native, args) * (180 / M_PI);
+
+	return ApplyNative(native, args);
+}
+
+// вычисление встроенной функции от аргумента в радианах
+double Calculator::ApplyNative(const NativeFunction& native, const double *args) const {
+	return native.kernel(args);
+}
+
+// округление до ближайшего целого при |x| < 2^51: младшие разряды суммы с 1.5 * 2^52 отбрасываются
+double Calculator::RoundNearest(double x) {
+	return (x + ROUND_SHIFT) - ROUND_SHIFT;
+}
+
+// приведение угла: x = q * pi/2 + r, |r| <= pi/4, возвращает номер четверти q mod 4
+// произведения q * PIO2_1 и q * PIO2_2 точны при |q| < 2^20, а трёх частей pi/2 хватает, чтобы вблизи q * pi/2
+// остаток r сохранял все значащие биты (при |x| < 1e5 он не меньше 1e-19)
+int Calculator::ReduceAngle(double x, double& r) {
+	double q = RoundNearest(x * M_2_PI);
+
+	r = ((x - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+
+	return (int) ((long long) q & 3);
+}
+
+// синус на отрезке [-pi/4, pi/4] многочленом Тейлора 17 степени (остаточный член меньше 1e-19)
+double Calculator::SinPolynomial(double r) {
+	double r2 = r * r;
+
+	return r + r * r2 * (-1.0 / 6 + r2 * (1.0 / 120 + r2 * (-1.0 / 5040 + r2 * (1.0 / 362880 + r2 * (-1.0 / 39916800 + r2 * (1.0 / 6227020800.0 + r2 * (-1.0 / 1307674368000.0 + r2 / 355687428096000.0)))))));
+}
+
+// косинус на отрезке [-pi/4, pi/4] многочленом Тейлора 18 степени (остаточный член меньше 1e-20)
+double Calculator::CosPolynomial(double r) {
+	double r2 = r * r;
+
+	return 1 - r2 / 2 + r2 * r2 * (1.0 / 24 + r2 * (-1.0 / 720 + r2 * (1.0 / 40320 + r2 * (-1.0 / 3628800 + r2 * (1.0 / 479001600 + r2 * (-1.0 / 87178291200.0 + r2 * (1.0 / 20922789888000.0 - r2 / 6402373705728000.0)))))));
+}
+
+// быстрый синус, при |x| < 1e5 ошибка не больше 2 ULP, иначе используется sin
+double Calculator::FastSin(double x) {
+	if (!(fabs(x) < 1e5))
+		return sin(x);
+
+	double r;
+	int q = ReduceAngle(x, r);
+
+	switch (q) {
+		case 0:
+			return SinPolynomial(r);
+
+		case 1:
+			return CosPolynomial(r);
+
+		case 2:
+			return -SinPolynomial(r);
+
+		default:
+			return -CosPolynomial(r);
+	}
+}
+
+// быстрый косинус, при |x| < 1e5 ошибка не больше 2 ULP, иначе используется cos
+double Calculator::FastCos(double x) {
+	if (!(fabs(x) < 1e5))
+		return cos(x);
+
+	double r;
+	int q = ReduceAngle(x, r);
+
+	switch (q) {
+		case 0:
+			return CosPolynomial(r);
+
+		case 1:
+			return -SinPolynomial(r);
+
+		case 2:
+			return -CosPolynomial(r);
+
+		default:
+			return SinPolynomial(r);
+	}
+}
+
+// быстрый тангенс как отношение приближений синуса и косинуса, при |x| < 1e5 ошибка не больше 4 ULP
+double Calculator::FastTan(double x) {
+	if (!(fabs(x) < 1e5))
+		return tan(x);
+
+	double r;
+	int q = ReduceAngle(x, r);
+
+	return q % 2 == 0 ? SinPolynomial(r) / CosPolynomial(r) : -CosPolynomial(r) / SinPolynomial(r);
+}
+
+// ошибка значения value относительно точного значения exact в единицах последнего разряда выбранной точности
+double Calculator::UlpError(double value, double exact) const {
+	if (value == exact || (isnan(value) && isnan(exact)))
+		return 0;
+
+	if (!isfinite(value) || !isfinite(exact))
+		return INFINITY;
+
+	double ulp = precision == Precision::Float ? nextafterf((float) fabs(exact), INFINITY) - (float) fabs(exact) : nextafter(fabs(exact), INFINITY) - fabs(exact);
+
+	return fabs(value - exact) / ulp;
+}
+
+// вычисление оператора над пользовательской функцией
+double Calculator::EvaluateFunctional(const string& name, const Function& function, double arg1, double arg2) const {
+	if (name == "integrate")
+		return Integrate(function, arg1, arg2);
+
+	if (name == "solve")
+		return Solve(function, arg1, arg2);
+
+	if (name == "sum")
+		return Sum(function, arg1, arg2);
+
+	throw string("unhandled function '") + name + "'";
+}
+
+// вычисление операции над дуальными числами
+Calculator::Dual Calculator::EvaluateOperator(const string& op, const Dual& arg1, const Dual& arg2) const {
+	return EvaluateOperator(GetOperation(op), arg1, arg2);
+}
+
+// вычисление операции над дуальными числами по её коду
+Calculator::Dual Calculator::EvaluateOperator(Operation op, const Dual& arg1, const Dual& arg2) const {
+	double value = EvaluateOperator(op, arg1.value, arg2.value);
+
+	switch (op) {
+		case Operation::Add:
+			return Dual(value, arg1.derivative + arg2.derivative);
+
+		case Operation::Subtract:
+			return Dual(value, arg1.derivative - arg2.derivative);
+
+		case Operation::Multiply:
+			return Dual(value, arg1.derivative * arg2.value + arg1.value * arg2.derivative);
+
+		case Operation::Divide:
+			return Dual(value, (arg1.derivative * arg2.value - arg1.value * arg2.derivative) / (arg2.value * arg2.value));
+
+		case Operation::Power: {
+			Dual args[2] = { arg1, arg2 };
+
+			return ApplyNative(natives[powIndex], args);
+		}
+
+		case Operation::Mod:
+			return Dual(value, arg1.derivative - trunc(arg1.value / arg2.value) * arg2.derivative);
+	}
+
+	throw string("unhandled operator");
+}
+
+// вычисление встроенной функции от дуальных чисел в радианах: f(u, v)' = f_u * u' + f_v * v'
+Calculator::Dual Calculator::ApplyNative(const NativeFunction& native, const Dual *args) const {
+	vector<double> values(native.arity);
+
+	// ядро одинарной точности округляет аргументы, и частные производные берутся в той же точке
+	for (size_t i = 0; i < native.arity; i++)
+		values[i] = native.single ? (float) args[i].value : args[i].value;
+
+	Dual result(native.kernel(values.data()));
+
+	for (size_t i = 0; i < native.arity; i++) {
+		if (args[i].derivative == 0) // аргумент не зависит от переменной
+			continue;
+
+		if (native.partials.size() != native.arity)
+			throw string("function '") + native.name + "' is not differentiable";
+
+		double partial = native.partials[i](values.data());
+
+		if (partial != 0) // результат не зависит от аргумента, даже если его производная не определена (max(nan, x))
+			result.derivative += partial * args[i].derivative;
+	}
+
+	return result;
+}
+
+// вычисление оператора над функцией от дуальных чисел
+Calculator::Dual Calculator::EvaluateFunctional(const string& name, const Function& function, const Dual& arg1, const Dual& arg2) const {
+	Dual result(EvaluateFunctional(name, function, arg1.value, arg2.value));
+
+	// от границ зависит только интеграл: (F(b) - F(a))' = f(b)b' - f(a)a'
+	if (name == "integrate") {
+		vector<double> frame;
+		result.derivative = Execute(function.program, arg2.value, frame) * arg2.derivative - Execute(function.program, arg1.value, frame) * arg1.derivative;
+	}
+
+	return result;
+}
+
+// вычисление операции над дробями
+Rational Calculator::EvaluateOperator(const string& op, const Rational& arg1, const Rational& arg2) const {
+	if (op == "+")
+		return arg1 + arg2;
+
+	if (op == "-")
+		return arg1 - arg2;
+
+	if (op == "*")
+		return arg1 * arg2;
+
+	if (op == "/")
+		return arg1 / arg2;
+
+	if (op == "^") {
+		if (!arg2.IsInteger())
+			throw string("non-integer power is not supported in exact arithmetic");
+
+		if (arg2 > Rational(POWER_LIMIT) || arg2 < Rational(-POWER_LIMIT))
+			throw string("power is too large for exact arithmetic");
+
+		long long exponent = arg2.ToInteger();
+
+		// размер дроби растёт пропорционально показателю, а умножение длинных чисел квадратично, поэтому размер результата ограничен до вычисления
+		if (arg1.Length() * llabs(exponent) > POWER_DIGITS)
+			throw string("power is too large for exact arithmetic");
+
+		return arg1.Power(exponent);
+	}
+
+	if (op == "mod") // остаток со знаком делимого, как у fmod
+		return arg1 - arg2 * Rational((arg1 / arg2).Trunc(), 1);
+
+	throw string("unhandled operator '") + op + "'";
+}
+
+// вычисление встроенной функции от дробей, точно вычисляются только функции с рациональным результатом
+Rational Calculator::EvaluateNative(const NativeFunction& native, const Rational *args) const {
+	switch (native.exact) {
+		case Exact::Abs:
+			return args[0].Sign() < 0 ? -args[0] : args[0];
+
+		case Exact::Sign:
+			return args[0].Sign();
+
+		case Exact::Min:
+			return args[1] < args[0] ? args[1] : args[0];
+
+		case Exact::Max:
+			return args[1] > args[0] ? args[1] : args[0];
+
+		case Exact::Pow:
+			return EvaluateOperator("^", args[0], args[1]);
+
+		default: // корень и остальные функции не дают рационального результата
+			break;
+	}
+
+	throw string("function '") + native.name + "' is not supported in exact arithmetic";
+}
+
+// вычисление операции над длинными числами
+BigFloat Calculator::EvaluateOperator(const string& op, const BigFloat& arg1, const BigFloat& arg2) const {
+	if (op == "+")
+		return arg1 + arg2;
+
+	if (op == "-")
+		return arg1 - arg2;
+
+	if (op == "*")
+		return arg1 * arg2;
+
+	if (op == "/")
+		return arg1 / arg2;
+
+	if (op == "^") {
+		if (!arg2.IsInteger())
+			throw string("non-integer power is not supported in precise arithmetic");
+
+		if (arg2 > BigFloat(POWER_LIMIT) || arg2 < BigFloat(-POWER_LIMIT))
+			throw string("power is too large for precise arithmetic");
+
+		return arg1.Power(arg2.ToInteger());
+	}
+
+	if (op == "mod")
+		return arg1 - arg2 * (arg1 / arg2).Trunc();
+
+	throw string("unhandled operator '") + op + "'";
+}
+
+// вычисление встроенной функции от длинных чисел
+BigFloat Calculator::EvaluateNative(const NativeFunction& native, const BigFloat *args) const {
+	switch (native.exact) {
+		case Exact::Abs:
+			return args[0].Sign() < 0 ? -args[0] : args[0];
+
+		case Exact::Sign:
+			return args[0].Sign();
+
+		case Exact::Min:
+			return args[1] < args[0] ? args[1] : args[0];
+
+		case Exact::Max:
+			return args[1] > args[0] ? args[1] : args[0];
+
+		case Exact::Pow:
+			return EvaluateOperator("^", args[0], args[1]);
+
+		case Exact::Sqrt:
+			return args[0].Sqrt();
+
+		default:
+			break;
+	}
+
+	throw string("function '") + native.name + "' is not supported in precise arithmetic";
+}
+
+// вычисление оператора над функцией в точной арифметике: поддерживается только суммирование
+template <typename T>
+T Calculator::EvaluateFunctional(const string& name, const Function& function, const T& arg1, const T& arg2) const {
+	if (name != "sum")
+		throw string("function '") + name + "' is supported only in double arithmetic";
+
+	// слагаемых floor(arg2 - arg1) + 1, ограничение то же, что и в двойной точности
+	if (!(arg2 - arg1 < T((long long) SUM_LIMIT)))
+		throw string("sum has too many terms");
+
+	T sum = 0;
+
+	for (T x = arg1; !(x > arg2); x = x + T(1))
+		sum = sum + EvaluateUserFunction(function, x);
+
+	return sum;
+}
+
+// получение значения числа или константы в двойной точности
+template <>
+double Calculator::ParseValue<double>(const string& token) const {
+	return IsConstant(token) ? EvaluateConstant(token) : ParseNumber(token);
+}
+
+// получение значения числа в виде дроби, иррациональные константы не представимы
+template <>
+Rational Calculator::ParseValue<Rational>(const string& token) const {
+	if (IsConstant(token))
+		throw string("constant '") + token + "' is not supported in exact arithmetic";
+
+	return Rational::FromString(token);
+}
+
+// получение значения числа или константы в виде длинного числа
+template <>
+BigFloat Calculator::ParseValue<BigFloat>(const string& token) const {
+	if (token == "pi")
+		return BigFloat::Pi();
+
+	if (token == "e")
+		return BigFloat::E();
+
+	return BigFloat::FromString(token);
+}
+
+// в двойной точности значение переменной уже вычислено
+template <>
+double Calculator::EvaluateVariable<double>(const Variable& variable) const {
+	return variable.value;
+}
+
+// в других арифметиках выражение переменной вычисляется заново, чтобы не терять точность
+template <typename T>
+T Calculator::EvaluateVariable(const Variable& variable) const {
+	return Evaluate<T>(variable.rpn);
+}
+
+// в двойной точности функция выполняется скомпилированной
+template <>
+double Calculator::EvaluateUserFunction<double>(const Function& function, const double& arg) const {
+	vector<double> frame;
+
+	return Execute(function.program, arg, frame);
+}
+
+// в других арифметиках вычисляется исходный полиз функции, так как свёрнутые константы скомпилированной программы неточны
+template <typename T>
+T Calculator::EvaluateUserFunction(const Function& function, const T& arg) const {
+	return Evaluate<T>(function.rpn, function.arg, arg);
+}
+
+// вычисление выражения, записанного в ПОЛИЗе, в арифметике T; arg - имя аргумента функции со значением value
+template <typename T>
+T Calculator::Evaluate(const vector<string>& rpn, const string& arg, const T& value) const {
+	stack<T> stack;
+
+	for (size_t i = 0; i < rpn.size(); i++) {
+		if (arg != "" && rpn[i] == arg) { // если аргумент функции (его имя может совпадать с именем встроенной функции)
+			stack.push(value);
+		}
+		else if (IsOperator(rpn[i])) {
+			if (stack.size() < 2)
+				throw string("unable to take arguments for operator '") + rpn[i] + "': stack size is too small";
+
+			// получаем аргументы из стека
+			T arg2 = stack.top();
+			stack.pop();
+			T arg1 = stack.top();
+			stack.pop();
+
+			stack.push(EvaluateOperator(rpn[i], arg1, arg2));
+		}
+		else if (rpn[i] == "!") { // если унарный минус
+			stack.top() = -stack.top(); // меняем знак у числа на верхушке стека
+		}
+		else if (IsNative(rpn[i])) {
+			const NativeFunction& native = GetNative(rpn[i]);
+
+			if (stack.size() < native.arity)
+				throw string("unable to take arguments for function '") + rpn[i] + "': stack size is too small";
+
+			vector<T> args(native.arity);
+
+			// получаем аргументы из стека
+			for (size_t j = native.arity; j > 0; j--) {
+				args[j - 1] = stack.top();
+				stack.pop();
+			}
+
+			stack.push(EvaluateNative(native, args.data()));
+		}
+		else if (IsFunctional(rpn[i])) {
+			if (stack.size() < 2 || i + 1 == rpn.size())
+				throw string("unable to take arguments for function '") + rpn[i] + "': stack size is too small";
+
+			const Function *function = GetFunction(rpn[i + 1]); // имя функции идёт сразу за оператором
+
+			if (function == nullptr)
+				throw string("unknown function '") + rpn[i + 1] + "'";
+
+			// получаем границы из стека
+			T arg2 = stack.top();
+			stack.pop();
+			T arg1 = stack.top();
+			stack.pop();
+
+			stack.push(EvaluateFunctional(rpn[i], *function, arg1, arg2));
+			i++; // пропускаем имя функции
+		}
+		else if (IsUserVariable(rpn[i])) { // если переменная
+			const Variable *variable = GetVariable(rpn[i]); // получаем значение переменной по её имени
+
+			if (variable == nullptr)
+				throw string("unknown variable '") + rpn[i] + "'";
+
+			stack.push(EvaluateVariable<T>(*variable)); // и добавляем его в стек
+		}
+		else if (IsUserFunction(rpn[i])) {
+			const Function *function = GetFunction(rpn[i]);
+
+			if (function == nullptr)
+				throw string("unknown function '") + rpn[i] + "'";
+
+			if (stack.size() == 0)
+				throw string("unable to take arguments for function '") + rpn[i] + "': stack size is too small";
+
+			T functionArg = stack.top(); // получаем аргумент функции
+
+			stack.pop();
+			stack.push(EvaluateUserFunction(*function, functionArg)); // закидываем результат вычисления функции
+		}
+		else { // число или константа, кидаем значение в стек
+			stack.push(ParseValue<T>(rpn[i]));
+		}
+	}
+
+	if (stack.size() != 1)
+		throw string("error during computation expression");
+
+	return stack.top();
+}
+
+// выполнение команды
+void Calculator::Calculate(const string& command) {
+	lexemes.clear();
+	rpn.clear();
+
+	SplitToLexemes(command);
+
+	if (lexemes.size() == 0)
+		throw string("Command is invalid");
 
 	// если определение функции
 	if (lexemes[0] == DEF) {
@@ -667,17 +2359,65 @@ void Calculator::Calculate(const string& command) {
 	else if (lexemes[0] == SET) { // если введение переменной
 		ParseSet();
 	}
+	else if (lexemes[0] == DIFF) { // если дифференцирование функции
+		ParseDiff();
+	}
 	else {
+		Arithmetic arithmetic = this->arithmetic;
+
+		// арифметика может быть задана для одной команды
+		if (lexemes[0] == DOUBLE || lexemes[0] == EXACT || lexemes[0] == PRECISE) {
+			arithmetic = lexemes[0] == EXACT ? Arithmetic::Exact : lexemes[0] == PRECISE ? Arithmetic::Precise : Arithmetic::Double;
+			NextLexeme();
+
+			if (lexemes.size() == 0)
+				throw string("expression is empty");
+		}
+
 		Addition(); // иначе парсим выражение
 
 		if (lexemes.size() > 0)
 			throw string("incorrect expression");
 
-		double result = Evaluate(rpn); // вычисляем его
-		cout << setprecision(15) << result << endl; // и выводим результат
+		// вычисляем его и выводим результат
+		if (arithmetic == Arithmetic::Exact) {
+			cout << Evaluate<Rational>(rpn).ToString() << endl;
+		}
+		else if (arithmetic == Arithmetic::Precise) {
+			cout << Evaluate<BigFloat>(rpn).ToString() << endl;
+		}
+		else {
+			double result = Evaluate<double>(rpn);
+			cout << setprecision(15) << result << endl;
+		}
 	}
 }
 
+// значение и производная пользовательской функции в точке за один проход по дуальным числам
+double Calculator::Differentiate(const string& name, double x, double& derivative) const {
+	const Function *function = GetFunction(name);
+
+	if (function == nullptr)
+		throw string("unknown function '") + name + "'";
+
+	vector<Dual> frame;
+	Dual result = Execute(function->program, Dual(x, 1), frame);
+
+	derivative = result.derivative;
+	return result.value;
+}
+
+// вычисление пользовательской функции для массива из count аргументов
+void Calculator::EvaluateBatch(const string& name, const double *args, double *results, size_t count) const {
+	const Function *function = GetFunction(name);
+
+	if (function == nullptr)
+		throw string("unknown function '") + name + "'";
+
+	vector<double> frame;
+	ExecuteBatch(function->program, args, results, count, frame);
+}
+
 // сброс информации о переменных и функциях
 void Calculator::Reset() {
 	userFunctions.clear();
@@ -711,16 +2451,141 @@ void Calculator::PrintState() const {
 	}
 }
 
+// максимальная ошибка встроенных функций в единицах последнего разряда относительно стандартной библиотеки
+vector<Calculator::Accuracy> Calculator::MeasureAccuracy() const {
+	Calculator strict(false, Precision::Strict); // эталонный калькулятор
+
+	// функции и отрезки, на которых оценивается ошибка
+	vector<Accuracy> accuracies = {
+		{ "sin", -1e5, 1e5 }, { "cos", -1e5, 1e5 }, { "tan", -1.5, 1.5 }, { "cot", 0.01, 3.1 },
+		{ "asin", -1, 1 }, { "acos", -1, 1 }, { "atan", -100, 100 }, { "sqrt", 0, 1e6 },
+		{ "ln", 1e-5, 1e5 }, { "lg", 1e-5, 1e5 }, { "exp", -700, 700 }, { "pow", 1e-3, 10 }, { "log", 1.5, 1e5 }
+	};
+
+	for (size_t i = 0; i < accuracies.size(); i++) {
+		Accuracy& accuracy = accuracies[i];
+
+		accuracy.periodic = false;
+		accuracy.error = 0;
+		accuracy.arg = accuracy.a;
+
+		for (int j = 0; j <= ACCURACY_SAMPLES; j++) {
+			double x = accuracy.a + (accuracy.b - accuracy.a) * j / ACCURACY_SAMPLES;
+			double value, exact;
+
+			if (precision == Precision::Float) // сравниваем на одном и том же аргументе одинарной точности
+				x = (float) x;
+
+			// бинарные функции проверяются на точках (x, 2.5) для pow и (2, x) для log
+			double args[2] = { x, 2.5 };
+
+			if (accuracy.name == "log") {
+				args[0] = 2;
+				args[1] = x;
+			}
+
+			value = ApplyNative(GetNative(accuracy.name), args);
+			exact = strict.ApplyNative(strict.GetNative(accuracy.name), args);
+
+			// значения вне диапазона одинарной точности не учитываются
+			if (precision == Precision::Float && fabs(exact) > FLT_MAX)
+				continue;
+
+			double error = UlpError(value, exact);
+
+			if (error > accuracy.error) {
+				accuracy.error = error;
+				accuracy.arg = x;
+			}
+		}
+	}
+
+	// ближайшие к k * pi/2 числа: значения тригонометрических функций здесь близки к нулю, и ошибка приведения угла наиболее заметна
+	vector<string> periodic = { "sin", "cos", "tan", "cot" };
+	int quarters = (int) (ACCURACY_PERIODIC_LIMIT / M_PI_2);
+
+	for (size_t i = 0; i < periodic.size(); i++) {
+		Accuracy accuracy = { periodic[i], 0, ACCURACY_PERIODIC_LIMIT, true, 0, 0 };
+
+		for (int k = 1; k <= quarters; k++) {
+			double x = precision == Precision::Float ? (float) (k * M_PI_2) : k * M_PI_2;
+			double value = ApplyNative(GetNative(periodic[i]), &x);
+			double exact = strict.ApplyNative(strict.GetNative(periodic[i]), &x);
+
+			if (precision == Precision::Float && fabs(exact) > FLT_MAX)
+				continue;
+
+			double error = UlpError(value, exact);
+
+			if (error > accuracy.error) {
+				accuracy.error = error;
+				accuracy.arg = x;
+			}
+		}
+
+		accuracies.push_back(accuracy);
+	}
+
+	return accuracies;
+}
+
+// допустимая ошибка встроенной функции: стандартная библиотека точна, быстрые приближения имеют оценки из комментариев к ним
+double Calculator::AccuracyBound(const string& name) const {
+	if (precision == Precision::Float)
+		return FLOAT_ULP;
+
+	if (precision == Precision::Fast && (name == "sin" || name == "cos"))
+		return FAST_SINCOS_ULP;
+
+	if (precision == Precision::Fast && (name == "tan" || name == "cot"))
+		return FAST_TANCOT_ULP;
+
+	return 0;
+}
+
+// вывод максимальной ошибки встроенных функций в единицах последнего разряда относительно стандартной библиотеки
+void Calculator::PrintAccuracy() const {
+	vector<Accuracy> accuracies = MeasureAccuracy();
+
+	streamsize outputPrecision = cout.precision();
+	cout << "Max ULP error against strict precision:" << endl << setprecision(4);
+
+	for (size_t i = 0; i < accuracies.size(); i++) {
+		const Accuracy& accuracy = accuracies[i];
+
+		cout << "  " << setw(5) << left << accuracy.name << right;
+
+		if (accuracy.periodic)
+			cout << " near k*pi/2 up to " << accuracy.b;
+		else
+			cout << " on [" << accuracy.a << ", " << accuracy.b << "]";
+
+		cout << ": " << accuracy.error << " ULP at " << accuracy.arg << endl;
+	}
+
+	cout << setprecision(outputPrecision);
+}
+
 void Calculator::PrintHelp() const {
 	cout << "Main commands:" << endl;
 	cout << "  help           print this message" << endl;
 	cout << "  print state    print defined variables and functions" << endl;
+	cout << "  print accuracy print max error of built-in functions against libm" << endl;
 	cout << "  reset          remove all defined variables and functions" << endl;
 	cout << "  def            start to function definition" << endl;
 	cout << "  set            start to variable definition" << endl;
+	cout << "  diff           define derivative of function" << endl;
 	cout << "  quit           terminate program" << endl;
 	cout << endl;
 
+	cout << "Arithmetic of single expression:" << endl;
+	cout << "  double [expression]   compute in double precision" << endl;
+	cout << "  exact [expression]    compute with exact rational numbers" << endl;
+	cout << "  precise [expression]  compute with 50 significant digits" << endl;
+	cout << endl;
+	cout << "Example: exact 1/3 + 1/6" << endl;
+	cout << endl;
+
 	cout << "Function definition syntax:" << endl;
 	cout << "  def [function name] = [function definition]" << endl;
 	cout << "    function name - word" << endl;
@@ -737,8 +2602,16 @@ void Calculator::PrintHelp() const {
 	cout << "Example: set twopi = 2 * pi" << endl;
 	cout << endl;
 
+	cout << "Derivative definition syntax:" << endl;
+	cout << "  diff([function name])" << endl;
+	cout << "    defines function d[function name] with symbolic derivative" << endl;
+	cout << endl;
+	cout << "Example: diff(f) defines df" << endl;
+	cout << endl;
+
 	cout << "Built-in functions and constants:" << endl;
 	cout << "  Trigonometry: sin, cos, tg, ctg, arcsin, arccos, arctg" << endl;
 	cout << "  Other functions: sqrt, log, ln, lg, exp, abs, sign, min, max, pow" << endl;
+	cout << "  Operators over user functions: integrate(f, a, b), solve(f, lo, hi), sum(f, a, b)" << endl;
 	cout << "  Constants: pi, e" << endl;
 }
\ No newline at end of file
@@ -0,0 +1,533 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+
+#include "Calculator.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+// перекрёстная проверка вычислителей: случайные функции вычисляются эталонной интерпретацией полиза,
+// байткодом, пакетно, пакетно в нескольких потоках и дуальными числами, результаты сравниваются с эталоном, а производительность - с сохранённой;
+// производная, вычисленная дуальными числами, сравнивается с эталонным вычислением производной, построенной командой diff
+class Checker {
+	const size_t POINTS = 256; // количество точек, в которых сравниваются вычислители
+	const size_t CHAIN = 4; // длина цепочки определений, функции которой могут вызывать предыдущие
+	const int DEPTH = 3; // максимальная глубина вложенности случайного выражения
+	const double TOLERANCE = 4; // допустимое расхождение вычислителей в единицах последнего разряда
+	const double DERIVATIVE_TOLERANCE = 1e6; // допустимое расхождение производных: дуальные числа и diff вычисляют разные формулы
+	const double SLOWDOWN = 0.2; // допустимое падение производительности относительно сохранённой
+	const size_t REPORTS = 5; // количество выводимых расхождений
+
+	Calculator& calculator; // калькулятор, в котором определяются проверяемые функции
+	mt19937 random; // генератор с фиксированным зерном, чтобы проверки повторялись
+
+	string RandomAddition(int depth); // случайное выражение из слагаемых
+	string RandomMultiplying(int depth, bool isUnary); // случайное произведение
+	string RandomExponenting(int depth, bool isUnary); // случайная степень
+	string RandomEntity(int depth); // случайный операнд
+
+	double Reference(const vector<string>& rpn, const string& arg, double value) const; // эталонное вычисление полиза
+	bool Differentiate(const string& name, const vector<double>& points, vector<double>& values, vector<bool>& failed); // эталонные значения производной
+	bool CheckAccuracy() const; // проверка ошибки встроенных функций всех точностей
+
+public:
+	Checker(Calculator& calculator); // конструктор из калькулятора, его определения будут заменены проверяемыми
+
+	bool Run(size_t count, const string& baseline = "", bool save = false); // проверка count случайных функций, возвращает true, если проверка пройдена
+};
+
+Checker::Checker(Calculator& calculator) : calculator(calculator) {
+}
+
+// случайное выражение из слагаемых по правилу Addition
+string Checker::RandomAddition(int depth) {
+	string expression = RandomMultiplying(depth, true);
+	size_t terms = random() % 3;
+
+	for (size_t i = 0; i < terms; i++)
+		expression += string(random() % 2 ? " + " : " - ") + RandomMultiplying(depth, false);
+
+	return expression;
+}
+
+// случайное произведение по правилу Multiplying
+string Checker::RandomMultiplying(int depth, bool isUnary) {
+	const vector<string> operations = { " * ", " / ", " mod " };
+
+	string expression = RandomExponenting(depth, isUnary);
+	size_t factors = random() % 3;
+
+	for (size_t i = 0; i < factors; i++)
+		expression += operations[random() % 4 % 3] + RandomExponenting(depth, false); // mod выбирается реже
+
+	return expression;
+}
+
+// случайная степень по правилу Exponenting, унарный минус допустим только в начале слагаемого
+string Checker::RandomExponenting(int depth, bool isUnary) {
+	string expression = isUnary && random() % 4 == 0 ? "-" : "";
+
+	expression += RandomEntity(depth);
+
+	if (random() % 5 == 0)
+		expression += " ^ " + RandomEntity(0);
+
+	return expression;
+}
+
+// случайный операнд по правилу Entity: число, константа, аргумент, скобки, встроенная или пользовательская функция
+string Checker::RandomEntity(int depth) {
+	size_t choice = random() % (depth > 0 ? 8 : 4);
+
+	if (choice == 0) { // число
+		string number = to_string(random() % 10);
+
+		if (random() % 3 == 0)
+			number += random() % 2 ? ".5" : ".25";
+
+		return number;
+	}
+
+	if (choice == 1)
+		return calculator.constants[random() % calculator.constants.size()];
+
+	if (choice <= 3)
+		return "x";
+
+	if (choice == 4)
+		return "(" + RandomAddition(depth - 1) + ")";
+
+	if (choice == 7 && calculator.userFunctions.size() > 0) {
+		const Calculator::Function& function = calculator.userFunctions[random() % calculator.userFunctions.size()];
+
+		// сумма по небольшому отрезку целых точек
+		if (random() % 4 == 0) {
+			size_t a = random() % 3;
+			return "sum(" + function.name + ", " + to_string(a) + ", " + to_string(a + random() % 5) + ")";
+		}
+
+		return function.name + "(" + RandomAddition(depth - 1) + ")";
+	}
+
+	const Calculator::NativeFunction& native = calculator.natives[random() % calculator.natives.size()];
+	string expression = native.name + "(";
+
+	for (size_t i = 0; i < native.arity; i++)
+		expression += (i > 0 ? ", " : "") + RandomAddition(depth - 1);
+
+	return expression + ")";
+}
+
+// эталонное вычисление полиза: вызовы пользовательских функций и суммы интерпретируют полиз вызываемой функции рекурсивно,
+// поэтому эталон не использует ни скомпилированные программы, ни свёрнутые константы, ни пакетное вычисление
+double Checker::Reference(const vector<string>& rpn, const string& arg, double value) const {
+	vector<double> stack;
+
+	for (size_t i = 0; i < rpn.size(); i++) {
+		const string& token = rpn[i];
+		size_t arity = 0; // количество аргументов из стека
+
+		if (token == arg) {
+			stack.push_back(value);
+			continue;
+		}
+
+		if (calculator.IsOperator(token) || calculator.IsFunctional(token))
+			arity = 2;
+		else if (calculator.IsNative(token))
+			arity = calculator.GetNative(token).arity;
+		else if (token == "!" || calculator.IsUserFunction(token))
+			arity = 1;
+
+		if (stack.size() < arity)
+			throw string("unable to take arguments for '") + token + "': stack size is too small";
+
+		vector<double> args(stack.end() - arity, stack.end());
+		stack.resize(stack.size() - arity);
+
+		if (calculator.IsOperator(token)) {
+			stack.push_back(calculator.EvaluateOperator(token, args[0], args[1]));
+		}
+		else if (token == "!") {
+			stack.push_back(-args[0]);
+		}
+		else if (calculator.IsNative(token)) {
+			stack.push_back(calculator.EvaluateNative(calculator.GetNative(token), args.data()));
+		}
+		else if (calculator.IsFunctional(token)) { // за оператором следует имя функции
+			if (token != "sum" || i + 1 == rpn.size())
+				throw string("function '") + token + "' is not supported by the reference";
+
+			const Calculator::Function *function = calculator.GetFunction(rpn[++i]);
+			double terms = calculator.SumTerms(args[0], args[1]);
+			double sum = 0;
+
+			for (double j = 0; j < terms; j++)
+				sum += Reference(function->rpn, function->arg, args[0] + j);
+
+			stack.push_back(sum);
+		}
+		else if (calculator.IsUserFunction(token)) {
+			const Calculator::Function *function = calculator.GetFunction(token);
+
+			stack.push_back(Reference(function->rpn, function->arg, args[0]));
+		}
+		else if (calculator.IsUserVariable(token)) {
+			stack.push_back(calculator.GetVariable(token)->value);
+		}
+		else if (calculator.IsConstant(token)) {
+			stack.push_back(calculator.EvaluateConstant(token));
+		}
+		else {
+			stack.push_back(calculator.ParseNumber(token));
+		}
+	}
+
+	if (stack.size() != 1)
+		throw string("error during computation expression");
+
+	return stack[0];
+}
+
+// эталонные значения символьной производной функции name в точках points, возвращает false, если производную построить нельзя
+bool Checker::Differentiate(const string& name, const vector<double>& points, vector<double>& values, vector<bool>& failed) {
+	ostringstream output;
+	streambuf *buffer = cout.rdbuf(output.rdbuf()); // команда diff печатает производную, проверке этот вывод не нужен
+
+	try {
+		calculator.Calculate(calculator.DIFF + "(" + name + ")");
+	}
+	catch (string error) {
+		cout.rdbuf(buffer);
+		return false;
+	}
+
+	cout.rdbuf(buffer);
+
+	const Calculator::Function& derivative = calculator.userFunctions.back();
+
+	for (size_t k = 0; k < points.size(); k++) {
+		try {
+			values[k] = Reference(derivative.rpn, derivative.arg, points[k]);
+			failed[k] = false;
+		}
+		catch (string error) {
+			failed[k] = true;
+		}
+	}
+
+	// производную удаляем, чтобы следующие случайные функции выбирались только из проверяемых
+	calculator.userFunctions.pop_back();
+	return true;
+}
+
+// ошибка встроенных функций каждой точности сравнивается с допустимой, превышение означает регрессию приближений
+bool Checker::CheckAccuracy() const {
+	const vector<Precision> precisions = { Precision::Strict, Precision::Fast, Precision::Float };
+	const vector<string> names = { "strict", "fast", "float" };
+
+	streamsize outputPrecision = cout.precision();
+	bool passed = true;
+
+	cout << "Accuracy of built-in functions:" << endl << setprecision(4);
+
+	for (size_t i = 0; i < precisions.size(); i++) {
+		Calculator tier(false, precisions[i]);
+		vector<Calculator::Accuracy> accuracies = tier.MeasureAccuracy();
+		double maxError = 0;
+
+		for (size_t j = 0; j < accuracies.size(); j++) {
+			const Calculator::Accuracy& accuracy = accuracies[j];
+			double bound = tier.AccuracyBound(accuracy.name);
+
+			maxError = max(maxError, accuracy.error);
+
+			if (accuracy.error <= bound)
+				continue;
+
+			cout << "  " << names[i] << " " << accuracy.name << (accuracy.periodic ? " near k*pi/2" : "") << ": " << accuracy.error << " ULP at " << accuracy.arg << ", bound " << bound << " ULP, INACCURATE" << endl;
+			passed = false;
+		}
+
+		cout << "  " << setw(6) << left << names[i] << right << ": max " << maxError << " ULP" << endl;
+	}
+
+	cout << setprecision(outputPrecision);
+	return passed;
+}
+
+// проверка count случайных функций из цепочек определений, производительность сравнивается с сохранённой в файле baseline
+// или, если save, записывается в него
+bool Checker::Run(size_t count, const string& baseline, bool save) {
+	const vector<string> engines = { "reference", "bytecode", "batch", "parallel", "dual" };
+
+	if (save && baseline == "")
+		throw string("no baseline file to save");
+
+	// отсутствующий файл не подменяется новым: иначе проверка производительности молча проходила бы
+	if (!save && baseline != "" && !ifstream(baseline).is_open())
+		throw string("baseline file '") + baseline + "' is not found, create it with the save argument";
+
+	ThreadPool& pool = ThreadPool::Shared();
+	vector<double> points(POINTS);
+
+	for (size_t k = 0; k < POINTS; k++)
+		points[k] = -10 + 20 * (k + 0.5) / POINTS;
+
+	vector<vector<double>> values(engines.size(), vector<double>(POINTS));
+	vector<vector<bool>> failed(engines.size(), vector<bool>(POINTS)); // выброшена ли ошибка при вычислении точки
+	vector<double> times(engines.size(), 0);
+	vector<size_t> mismatches(engines.size(), 0);
+	vector<string> reports;
+	size_t functions = 0;
+	vector<double> frame;
+	vector<Calculator::Dual> dualFrame;
+	vector<double> derivatives(POINTS); // производные, вычисленные дуальными числами
+	vector<double> expected(POINTS); // значения производной, построенной командой diff
+	vector<bool> expectedFailed(POINTS);
+
+	random.seed(mt19937::default_seed);
+
+	for (size_t i = 0; i < count; i++) {
+		if (i % CHAIN == 0)
+			calculator.Reset();
+
+		string expression = RandomAddition(DEPTH);
+		string name = "f" + to_string(calculator.userFunctions.size());
+
+		try {
+			calculator.Calculate(calculator.DEF + " " + name + "(x) = " + expression);
+		}
+		catch (string error) { // сгенерированное выражение должно разбираться всегда
+			mismatches[0]++;
+
+			if (reports.size() < REPORTS)
+				reports.push_back(name + "(x) = " + expression + ": " + error);
+
+			continue;
+		}
+
+		const Calculator::Function& function = calculator.userFunctions.back();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+		for (size_t k = 0; k < POINTS; k++) {
+			try {
+				values[0][k] = Reference(function.rpn, function.arg, points[k]);
+				failed[0][k] = false;
+			}
+			catch (string error) {
+				failed[0][k] = true;
+			}
+		}
+
+		chrono::steady_clock::time_point end = chrono::steady_clock::now();
+		times[0] += chrono::duration<double>(end - start).count();
+		start = end;
+
+		for (size_t k = 0; k < POINTS; k++) {
+			try {
+				values[1][k] = calculator.Execute(function.program, points[k], frame);
+				failed[1][k] = false;
+			}
+			catch (string error) {
+				failed[1][k] = true;
+				frame.clear();
+			}
+		}
+
+		end = chrono::steady_clock::now();
+		times[1] += chrono::duration<double>(end - start).count();
+		start = end;
+
+		try {
+			calculator.ExecuteBatch(function.program, points.data(), values[2].data(), POINTS, frame);
+			failed[2].assign(POINTS, false);
+		}
+		catch (string error) { // ошибка в пакете относится ко всем его точкам
+			failed[2].assign(POINTS, true);
+			frame.clear();
+		}
+
+		end = chrono::steady_clock::now();
+		times[2] += chrono::duration<double>(end - start).count();
+		start = end;
+
+		size_t size = (POINTS + pool.Size() - 1) / pool.Size(); // количество точек на поток
+		vector<future<double>> parts;
+
+		for (size_t from = 0; from < POINTS; from += size) {
+			size_t to = min(from + size, POINTS);
+
+			parts.push_back(pool.Submit([this, &function, &points, &values, from, to]() {
+				vector<double> frame; // у каждого потока свой кадр вычислений
+				calculator.ExecuteBatch(function.program, points.data() + from, values[3].data() + from, to - from, frame);
+
+				return 0.0;
+			}));
+		}
+
+		for (size_t j = 0; j < parts.size(); j++) {
+			size_t from = j * size;
+			size_t to = min(from + size, POINTS);
+			bool error = false;
+
+			try {
+				parts[j].get();
+			}
+			catch (string) {
+				error = true;
+			}
+
+			for (size_t k = from; k < to; k++)
+				failed[3][k] = error;
+		}
+
+		end = chrono::steady_clock::now();
+		times[3] += chrono::duration<double>(end - start).count();
+		start = end;
+
+		for (size_t k = 0; k < POINTS; k++) {
+			try {
+				Calculator::Dual result = calculator.Execute(function.program, Calculator::Dual(points[k], 1), dualFrame);
+
+				values[4][k] = result.value;
+				derivatives[k] = result.derivative;
+				failed[4][k] = false;
+			}
+			catch (string error) {
+				failed[4][k] = true;
+				dualFrame.clear();
+			}
+		}
+
+		end = chrono::steady_clock::now();
+		times[4] += chrono::duration<double>(end - start).count();
+
+		// производная дуальными числами сравнивается с эталонным вычислением символьной производной, если её удаётся построить
+		bool differentiable = Differentiate(name, points, expected, expectedFailed);
+
+		// сравнение с эталоном: пакет может выбросить ошибку, только если она есть хотя бы в одной его точке
+		for (size_t e = 1; e < engines.size(); e++) {
+			bool referenceFailed = false;
+			bool mismatch = false;
+			size_t point = 0;
+
+			for (size_t k = 0; k < POINTS; k++)
+				referenceFailed |= failed[0][k];
+
+			bool pointwise = engines[e] == "bytecode" || engines[e] == "dual"; // ошибка относится к одной точке, а не к пакету
+			bool derivativeMismatch = false;
+
+			for (size_t k = 0; k < POINTS && !mismatch; k++) {
+				if (failed[e][k])
+					mismatch = pointwise ? !failed[0][k] : !referenceFailed;
+				else
+					mismatch = failed[0][k] || calculator.UlpError(values[e][k], values[0][k]) > TOLERANCE;
+
+				// в точке с неконечным значением производная не имеет смысла, а символьная производная может содержать устранимые особенности (0 * ln 0), которых нет у дуальных чисел
+				if (!mismatch && engines[e] == "dual" && differentiable && !failed[e][k] && !expectedFailed[k] && isfinite(values[e][k]) && isfinite(expected[k]))
+					mismatch = derivativeMismatch = calculator.UlpError(derivatives[k], expected[k]) > DERIVATIVE_TOLERANCE;
+
+				point = k;
+			}
+
+			if (!mismatch)
+				continue;
+
+			mismatches[e]++;
+
+			if (reports.size() < REPORTS) {
+				ostringstream report;
+				report << setprecision(17) << name << "(x) = " << expression << " at x = " << points[point] << ": reference ";
+
+				if (failed[0][point])
+					report << "error";
+				else
+					report << values[0][point];
+
+				report << ", " << engines[e] << " ";
+
+				if (failed[e][point])
+					report << "error";
+				else
+					report << values[e][point];
+
+				if (derivativeMismatch)
+					report << ", derivative " << derivatives[point] << ", diff " << expected[point];
+
+				reports.push_back(report.str());
+			}
+		}
+
+		functions++;
+	}
+
+	// чтение сохранённой производительности
+	unordered_map<string, double> saved;
+
+	if (!save && baseline != "") {
+		ifstream input(baseline);
+		string engine;
+		double throughput;
+
+		while (input >> engine >> throughput)
+			saved[engine] = throughput;
+	}
+
+	streamsize outputPrecision = cout.precision();
+	bool passed = true;
+
+	cout << "Checked " << functions << " functions on " << POINTS << " points, tolerance " << TOLERANCE << " ULP:" << endl;
+
+	for (size_t e = 0; e < engines.size(); e++) {
+		double throughput = times[e] > 0 ? functions * POINTS / times[e] : 0;
+
+		cout << "  " << setw(9) << left << engines[e] << right << ": " << setw(8) << mismatches[e] << " mismatches, " << setprecision(4) << throughput << " evaluations/s";
+
+		if (saved.count(engines[e])) {
+			double ratio = throughput / saved[engines[e]];
+
+			cout << " (" << setprecision(3) << ratio << "x of baseline";
+
+			if (ratio < 1 - SLOWDOWN) {
+				cout << ", SLOWDOWN";
+				passed = false;
+			}
+
+			cout << ")";
+		}
+
+		cout << endl;
+		passed = passed && mismatches[e] == 0;
+		saved[engines[e]] = saved.count(engines[e]) ? saved[engines[e]] : throughput;
+	}
+
+	cout << setprecision(outputPrecision);
+
+	for (size_t i = 0; i < reports.size(); i++)
+		cout << "  mismatch: " << reports[i] << endl;
+
+	passed = CheckAccuracy() && passed;
+
+	// сохранение текущей производительности
+	if (save) {
+		ofstream output(baseline);
+
+		for (size_t e = 0; e < engines.size(); e++)
+			output << engines[e] << " " << setprecision(17) << saved[engines[e]] << endl;
+
+		cout << "Baseline saved to " << baseline << endl;
+	}
+
+	cout << (passed ? "Check passed" : "Check FAILED") << endl;
+	return passed;
+}
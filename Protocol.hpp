@@ -0,0 +1,200 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+// Протокол сервера: каждый кадр начинается с длины остальной части (4 байта, little-endian).
+// Запрос:  [длина][id: 4 байта][тип: 1 байт][тело]
+//   Command  - тело: текст команды калькулятора, ответ - её вывод
+//   Evaluate - тело: [аргумент: 8 байт double][имя пользовательской функции], ответ - значение (8 байт double)
+// Ответ:   [длина][id: 4 байта][статус: 1 байт][тело], при ошибке тело содержит текст ошибки
+// Клиент может отправлять запросы, не дожидаясь ответов; ответы сопоставляются с запросами по id.
+
+const string DEFAULT_ADDRESS = "/tmp/calculator.sock"; // адрес сервера по умолчанию
+const uint32_t MAX_FRAME_SIZE = 1 << 20; // максимальный размер кадра
+const size_t FRAME_HEADER_SIZE = 9; // размер длины, id и типа (статуса)
+
+// тип запроса
+enum class RequestType : uint8_t {
+	Command = 0, // выполнение команды
+	Evaluate = 1 // вычисление пользовательской функции в точке
+};
+
+// статус ответа
+enum class ResponseStatus : uint8_t {
+	Ok = 0, // успешное выполнение
+	Error = 1 // ошибка, тело содержит её текст
+};
+
+void PutUint32(string& buffer, uint32_t value); // запись 4-байтного числа в буфер
+uint32_t GetUint32(const char *data); // чтение 4-байтного числа
+void PutDouble(string& buffer, double value); // запись вещественного числа в буфер
+double GetDouble(const char *data); // чтение вещественного числа
+
+string EncodeFrame(uint32_t id, uint8_t type, const string& body); // кодирование кадра
+string EncodeCommand(uint32_t id, const string& command); // кодирование запроса на выполнение команды
+string EncodeEvaluate(uint32_t id, const string& name, double arg); // кодирование запроса на вычисление функции
+bool ExtractFrame(string& buffer, string& frame); // извлечение полного кадра из начала буфера
+
+int OpenSocket(const string& address, bool listening); // открытие сокета: порт на localhost или путь к Unix-сокету
+void SetNonBlocking(int fd); // перевод сокета в неблокирующий режим
+
+// запись 4-байтного числа в буфер
+void PutUint32(string& buffer, uint32_t value) {
+	for (int i = 0; i < 4; i++)
+		buffer += (char) ((value >> (8 * i)) & 0xFF);
+}
+
+// чтение 4-байтного числа
+uint32_t GetUint32(const char *data) {
+	uint32_t value = 0;
+
+	for (int i = 0; i < 4; i++)
+		value |= (uint32_t) (uint8_t) data[i] << (8 * i);
+
+	return value;
+}
+
+// запись вещественного числа в буфер побитово
+void PutDouble(string& buffer, double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	PutUint32(buffer, bits & 0xFFFFFFFF);
+	PutUint32(buffer, bits >> 32);
+}
+
+// чтение вещественного числа
+double GetDouble(const char *data) {
+	uint64_t bits = GetUint32(data) | (uint64_t) GetUint32(data + 4) << 32;
+	double value;
+
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// кодирование кадра: длина, id, тип или статус и тело
+string EncodeFrame(uint32_t id, uint8_t type, const string& body) {
+	string frame;
+
+	PutUint32(frame, FRAME_HEADER_SIZE - 4 + body.length());
+	PutUint32(frame, id);
+	frame += (char) type;
+	frame += body;
+
+	return frame;
+}
+
+// кодирование запроса на выполнение команды
+string EncodeCommand(uint32_t id, const string& command) {
+	return EncodeFrame(id, (uint8_t) RequestType::Command, command);
+}
+
+// кодирование запроса на вычисление функции
+string EncodeEvaluate(uint32_t id, const string& name, double arg) {
+	string body;
+
+	PutDouble(body, arg);
+	body += name;
+
+	return EncodeFrame(id, (uint8_t) RequestType::Evaluate, body);
+}
+
+// извлечение полного кадра (без длины) из начала буфера, возвращает false, если кадр ещё не получен целиком
+bool ExtractFrame(string& buffer, string& frame) {
+	if (buffer.length() < 4)
+		return false;
+
+	uint32_t length = GetUint32(buffer.data());
+
+	if (length < FRAME_HEADER_SIZE - 4 || length > MAX_FRAME_SIZE)
+		throw string("incorrect frame length ") + to_string(length);
+
+	if (buffer.length() < 4 + length)
+		return false;
+
+	frame = buffer.substr(4, length);
+	buffer.erase(0, 4 + length);
+
+	return true;
+}
+
+// открытие сокета: адрес из цифр задаёт TCP-порт на localhost, иначе это путь к Unix-сокету
+int OpenSocket(const string& address, bool listening) {
+	bool tcp = address.length() > 0 && address.find_first_not_of("0123456789") == string::npos;
+	int fd = socket(tcp ? AF_INET : AF_UNIX, SOCK_STREAM, 0);
+
+	if (fd < 0)
+		throw string("unable to create socket: ") + strerror(errno);
+
+	sockaddr_storage storage;
+	socklen_t length;
+
+	memset(&storage, 0, sizeof(storage));
+
+	if (tcp) {
+		sockaddr_in *addr = (sockaddr_in *) &storage;
+
+		addr->sin_family = AF_INET;
+		addr->sin_port = htons(stoi(address));
+		addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		length = sizeof(sockaddr_in);
+
+		int flag = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag)); // ответы отправляются без задержки
+
+		if (listening)
+			setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+	}
+	else {
+		sockaddr_un *addr = (sockaddr_un *) &storage;
+
+		if (address.length() >= sizeof(addr->sun_path))
+			throw string("socket path '") + address + "' is too long";
+
+		addr->sun_family = AF_UNIX;
+		strcpy(addr->sun_path, address.c_str());
+		length = sizeof(sockaddr_un);
+
+		// удаляем оставшийся от прошлого запуска сокет, но не другие файлы
+		struct stat info;
+
+		if (listening && stat(address.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+			unlink(address.c_str());
+	}
+
+	int result = listening ? bind(fd, (sockaddr *) &storage, length) : connect(fd, (sockaddr *) &storage, length);
+
+	if (result == 0 && listening)
+		result = listen(fd, SOMAXCONN);
+
+	if (result != 0) {
+		string error = strerror(errno);
+		close(fd);
+
+		throw string("unable to ") + (listening ? "listen on '" : "connect to '") + address + "': " + error;
+	}
+
+	return fd;
+}
+
+// перевод сокета в неблокирующий режим
+void SetNonBlocking(int fd) {
+	int flags = fcntl(fd, F_GETFL, 0);
+
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+		throw string("unable to make socket non-blocking: ") + strerror(errno);
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include <poll.h>
+
+#include "Calculator.hpp"
+#include "Protocol.hpp"
+
+using namespace std;
+
+// сервер вычислений: однопоточный цикл событий на poll, все клиенты разделяют определения одного калькулятора
+class Server {
+	static const size_t READ_SIZE = 65536; // размер блока чтения из сокета
+
+	// соединение с клиентом
+	struct Connection {
+		string input; // принятые, но ещё не разобранные байты
+		string output; // ответы, ожидающие отправки
+		bool finished; // закончил ли клиент отправку запросов (ответы ещё нужно отправить)
+		bool closed; // нужно ли закрыть соединение
+	};
+
+	// запрос на вычисление функции, ожидающий пакетного вычисления
+	struct PendingRequest {
+		int fd; // сокет клиента
+		uint32_t id; // номер запроса
+		double arg; // аргумент функции
+	};
+
+	Calculator& calculator; // калькулятор с общими определениями
+	int listener; // слушающий сокет
+
+	map<int, Connection> connections; // соединения по сокетам
+	unordered_map<string, vector<PendingRequest>> pending; // ожидающие запросы по именам функций
+
+	size_t batches; // количество выполненных пакетных вычислений
+	size_t evaluations; // количество вычисленных запросов
+
+	void Accept(); // приём новых соединений
+	void Read(int fd, Connection& connection); // чтение данных и разбор кадров
+	void Write(int fd, Connection& connection); // отправка накопленных ответов
+	void Handle(int fd, const string& frame); // обработка одного кадра
+	void Respond(int fd, uint32_t id, ResponseStatus status, const string& body); // добавление ответа в очередь соединения
+	string Execute(const string& command); // выполнение команды калькулятора с перехватом вывода
+	void Flush(); // пакетное вычисление ожидающих запросов
+
+public:
+	Server(Calculator& calculator, const string& address); // конструктор из калькулятора и адреса
+	~Server();
+
+	void Run(); // запуск цикла событий
+};
+
+Server::Server(Calculator& calculator, const string& address) : calculator(calculator) {
+	listener = OpenSocket(address, true);
+	SetNonBlocking(listener);
+
+	batches = 0;
+	evaluations = 0;
+}
+
+Server::~Server() {
+	for (map<int, Connection>::iterator i = connections.begin(); i != connections.end(); i++)
+		close(i->first);
+
+	close(listener);
+}
+
+// приём всех ожидающих соединений
+void Server::Accept() {
+	int fd;
+
+	while ((fd = accept(listener, nullptr, nullptr)) >= 0) {
+		SetNonBlocking(fd);
+		connections[fd] = { "", "", false, false };
+	}
+}
+
+// чтение всех доступных данных и обработка полученных кадров
+void Server::Read(int fd, Connection& connection) {
+	char buffer[READ_SIZE];
+	ssize_t size;
+
+	while ((size = recv(fd, buffer, READ_SIZE, 0)) > 0)
+		connection.input.append(buffer, size);
+
+	if (size == 0) // клиент закончил отправку, но может ждать ответы на уже отправленные запросы
+		connection.finished = true;
+	else if (errno != EAGAIN && errno != EWOULDBLOCK) // ошибка соединения
+		connection.closed = true;
+
+	string frame;
+
+	try {
+		while (ExtractFrame(connection.input, frame))
+			Handle(fd, frame);
+	}
+	catch (string error) { // некорректный кадр: дальнейший поток не может быть разобран
+		cerr << "connection " << fd << ": " << error << endl;
+		connection.closed = true;
+	}
+}
+
+// отправка накопленных ответов, сколько примет сокет
+void Server::Write(int fd, Connection& connection) {
+	while (connection.output.length() > 0) {
+		ssize_t size = send(fd, connection.output.data(), connection.output.length(), MSG_NOSIGNAL);
+
+		if (size <= 0) {
+			if (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+				connection.closed = true;
+
+			return;
+		}
+
+		connection.output.erase(0, size);
+	}
+}
+
+// обработка одного кадра: вычисления откладываются до конца итерации, команды выполняются сразу
+void Server::Handle(int fd, const string& frame) {
+	uint32_t id = GetUint32(frame.data());
+	RequestType type = (RequestType) frame[4];
+	string body = frame.substr(FRAME_HEADER_SIZE - 4);
+
+	if (type == RequestType::Evaluate) {
+		if (body.length() <= sizeof(double)) {
+			Respond(fd, id, ResponseStatus::Error, "incorrect evaluate request");
+			return;
+		}
+
+		pending[body.substr(sizeof(double))].push_back({ fd, id, GetDouble(body.data()) });
+		return;
+	}
+
+	if (type != RequestType::Command) {
+		Respond(fd, id, ResponseStatus::Error, "unknown request type");
+		return;
+	}
+
+	Flush(); // команда может изменить определения, поэтому сначала вычисляем отложенные запросы
+
+	try {
+		Respond(fd, id, ResponseStatus::Ok, Execute(body));
+	}
+	catch (string error) {
+		Respond(fd, id, ResponseStatus::Error, error);
+	}
+	catch (const exception& error) { // исключения стандартной библиотеки не должны останавливать сервер
+		Respond(fd, id, ResponseStatus::Error, error.what());
+	}
+}
+
+// добавление ответа в очередь соединения
+void Server::Respond(int fd, uint32_t id, ResponseStatus status, const string& body) {
+	connections[fd].output += EncodeFrame(id, (uint8_t) status, body);
+}
+
+// выполнение команды калькулятора, вывод перехватывается и возвращается клиенту
+string Server::Execute(const string& command) {
+	ostringstream output;
+	streambuf *buffer = cout.rdbuf(output.rdbuf());
+
+	try {
+		if (command == "help") {
+			calculator.PrintHelp();
+		}
+		else if (command == "print state") {
+			calculator.PrintState();
+		}
+		else if (command == "print accuracy") {
+			calculator.PrintAccuracy();
+		}
+		else if (command == "reset") {
+			calculator.Reset();
+		}
+		else if (command == "print server") {
+			cout << "Connections: " << connections.size() << ", evaluations: " << evaluations << ", batches: " << batches << endl;
+		}
+		else {
+			calculator.Calculate(command);
+		}
+	}
+	catch (...) {
+		cout.rdbuf(buffer);
+		throw;
+	}
+
+	cout.rdbuf(buffer);
+	return output.str();
+}
+
+// вычисление всех ожидающих запросов к одной функции одним пакетным вызовом
+void Server::Flush() {
+	for (unordered_map<string, vector<PendingRequest>>::iterator i = pending.begin(); i != pending.end(); i++) {
+		vector<PendingRequest>& requests = i->second;
+		vector<double> args(requests.size());
+		vector<double> results(requests.size());
+
+		for (size_t j = 0; j < requests.size(); j++)
+			args[j] = requests[j].arg;
+
+		try {
+			calculator.EvaluateBatch(i->first, args.data(), results.data(), requests.size());
+			batches++;
+		}
+		catch (...) {
+			// ошибка в пакете: вычисляем запросы по одному, чтобы ошибка досталась только своему запросу
+			for (size_t j = 0; j < requests.size(); j++) {
+				string error;
+
+				try {
+					calculator.EvaluateBatch(i->first, &args[j], &results[j], 1);
+					continue;
+				}
+				catch (string message) {
+					error = message;
+				}
+				catch (const exception& exception) {
+					error = exception.what();
+				}
+
+				Respond(requests[j].fd, requests[j].id, ResponseStatus::Error, error);
+				requests[j].fd = -1; // ответ уже отправлен
+			}
+		}
+
+		for (size_t j = 0; j < requests.size(); j++) {
+			if (requests[j].fd < 0)
+				continue;
+
+			string body;
+			PutDouble(body, results[j]);
+
+			Respond(requests[j].fd, requests[j].id, ResponseStatus::Ok, body);
+		}
+
+		evaluations += requests.size();
+	}
+
+	pending.clear();
+}
+
+// цикл событий: приём соединений, чтение запросов, пакетное вычисление и отправка ответов
+void Server::Run() {
+	vector<pollfd> fds;
+
+	while (true) {
+		fds.clear();
+		fds.push_back({ listener, POLLIN, 0 });
+
+		// от закончившего отправку клиента больше не читаем, иначе poll постоянно сообщал бы о конце потока
+		for (map<int, Connection>::iterator i = connections.begin(); i != connections.end(); i++)
+			fds.push_back({ i->first, (short) ((i->second.finished ? 0 : POLLIN) | (i->second.output.length() ? POLLOUT : 0)), 0 });
+
+		if (poll(fds.data(), fds.size(), -1) < 0) {
+			if (errno == EINTR)
+				continue;
+
+			throw string("poll failed: ") + strerror(errno);
+		}
+
+		if (fds[0].revents & POLLIN)
+			Accept();
+
+		// сначала читаем все соединения, чтобы в пакет попали запросы от всех клиентов
+		for (size_t i = 1; i < fds.size(); i++)
+			if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+				Read(fds[i].fd, connections[fds[i].fd]);
+
+		Flush();
+
+		for (map<int, Connection>::iterator i = connections.begin(); i != connections.end(); ) {
+			Write(i->first, i->second);
+
+			// соединение закончившего отправку клиента закрывается, когда все ответы отправлены
+			if (i->second.closed || (i->second.finished && i->second.output.length() == 0)) {
+				close(i->first);
+				i = connections.erase(i);
+			}
+			else {
+				i++;
+			}
+		}
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+
+using namespace std;
+
+// общий пул потоков: потоки создаются один раз, задачи ставятся в общую очередь
+class ThreadPool {
+	vector<thread> workers; // рабочие потоки
+	queue<function<void()>> tasks; // очередь задач
+	mutex lock; // защита очереди
+	condition_variable available; // сигнал о новой задаче или остановке
+	bool stopping; // останавливается ли пул
+
+	static bool& IsWorkerFlag(); // флаг текущего потока
+	void Work(); // цикл рабочего потока
+
+public:
+	ThreadPool(size_t size); // конструктор из количества потоков
+	~ThreadPool();
+
+	static ThreadPool& Shared(); // общий пул по числу аппаратных потоков
+	static bool IsWorker(); // выполняется ли текущий код в потоке пула
+
+	size_t Size() const; // количество потоков
+	future<double> Submit(function<double()> task); // постановка задачи в очередь
+};
+
+ThreadPool::ThreadPool(size_t size) {
+	stopping = false;
+
+	for (size_t i = 0; i < size; i++)
+		workers.push_back(thread(&ThreadPool::Work, this));
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		unique_lock<mutex> guard(lock);
+		stopping = true;
+	}
+
+	available.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+// флаг текущего потока
+bool& ThreadPool::IsWorkerFlag() {
+	static thread_local bool worker = false;
+
+	return worker;
+}
+
+// цикл рабочего потока: выполняет задачи, пока пул не остановлен и очередь не пуста
+void ThreadPool::Work() {
+	IsWorkerFlag() = true;
+
+	while (true) {
+		function<void()> task;
+
+		{
+			unique_lock<mutex> guard(lock);
+			available.wait(guard, [this]() { return stopping || !tasks.empty(); });
+
+			if (tasks.empty())
+				return;
+
+			task = move(tasks.front());
+			tasks.pop();
+		}
+
+		task();
+	}
+}
+
+// общий пул по числу аппаратных потоков, создаётся при первом использовании
+ThreadPool& ThreadPool::Shared() {
+	static ThreadPool pool(max(1u, thread::hardware_concurrency()));
+
+	return pool;
+}
+
+// задачи, выполняемые в пуле, не должны ждать других задач пула, иначе все потоки могут оказаться в ожидании
+bool ThreadPool::IsWorker() {
+	return IsWorkerFlag();
+}
+
+// количество потоков
+size_t ThreadPool::Size() const {
+	return workers.size();
+}
+
+// постановка задачи в очередь, исключения задачи пробрасываются через future
+future<double> ThreadPool::Submit(function<double()> task) {
+	shared_ptr<packaged_task<double()>> packaged = make_shared<packaged_task<double()>>(task);
+	future<double> result = packaged->get_future();
+
+	{
+		unique_lock<mutex> guard(lock);
+		tasks.push([packaged]() { (*packaged)(); });
+	}
+
+	available.notify_one();
+	return result;
+}
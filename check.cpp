@@ -0,0 +1,56 @@
+#include <iostream>
+#include <string>
+
+#include "Checker.hpp"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+	size_t count = 1000;
+	string baseline;
+	bool save = false;
+	bool degrees = false;
+	Precision precision = Precision::Strict;
+
+	// количество функций, файл производительности, его перезапись, режим тригонометрии и точность функций задаются аргументами командной строки
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+
+		if (arg == "degrees") {
+			degrees = true;
+		}
+		else if (arg == "fast") {
+			precision = Precision::Fast;
+		}
+		else if (arg == "float") {
+			precision = Precision::Float;
+		}
+		else if (arg == "save") {
+			save = true;
+		}
+		else if (arg == "strict" || arg == "radians") {
+			continue;
+		}
+		else if (arg.find_first_not_of("0123456789") == string::npos) {
+			count = stoul(arg);
+		}
+		else if (arg[0] == '-') {
+			cout << "Usage: " << argv[0] << " [functions] [baseline file] [save] [radians|degrees] [strict|fast|float]" << endl;
+			return -1;
+		}
+		else {
+			baseline = arg;
+		}
+	}
+
+	try {
+		Calculator calculator(degrees, precision);
+		Checker checker(calculator);
+
+		return checker.Run(count, baseline, save) ? 0 : 1;
+	}
+	catch (string error) {
+		cout << "error: " << error << endl;
+		return -1;
+	}
+}
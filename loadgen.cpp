@@ -0,0 +1,208 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include "Calculator.hpp"
+#include "Protocol.hpp"
+
+using namespace std;
+
+const string FUNCTION_NAME = "loadgen"; // имя функции, вычисляемой под нагрузкой
+const string FUNCTION_DEFINITION = "def loadgen(x) = x^2 + sin(x) / (1 + abs(x))"; // её определение
+const size_t DISTINCT_ARGS = 1000; // количество различных аргументов запросов
+
+// результаты одного клиента
+struct Worker {
+	vector<double> latencies; // задержки ответов в микросекундах
+	size_t errors = 0; // количество ответов с ошибкой
+	size_t mismatches = 0; // количество значений, не совпавших с локальным вычислением
+	string failure; // ошибка соединения
+};
+
+// аргумент запроса с номером id
+double Argument(size_t id) {
+	return (double) (id % DISTINCT_ARGS) * 0.01 - 5;
+}
+
+// отправка всего буфера в блокирующий сокет
+void SendAll(int fd, const string& data) {
+	for (size_t offset = 0; offset < data.length(); ) {
+		ssize_t size = send(fd, data.data() + offset, data.length() - offset, MSG_NOSIGNAL);
+
+		if (size <= 0)
+			throw string("unable to send request: ") + strerror(errno);
+
+		offset += size;
+	}
+}
+
+// получение одного полного ответа на запрос
+string Receive(int fd, string& input) {
+	char buffer[4096];
+	string frame;
+
+	while (!ExtractFrame(input, frame)) {
+		ssize_t size = recv(fd, buffer, sizeof(buffer), 0);
+
+		if (size <= 0)
+			throw string("connection closed by server");
+
+		input.append(buffer, size);
+	}
+
+	return frame;
+}
+
+// выполнение команды на сервере и получение её вывода
+string Command(const string& address, const string& command) {
+	int fd = OpenSocket(address, false);
+	string input;
+
+	SendAll(fd, EncodeCommand(0, command));
+	string frame = Receive(fd, input);
+	close(fd);
+
+	if ((ResponseStatus) frame[4] != ResponseStatus::Ok)
+		throw string(frame.substr(FRAME_HEADER_SIZE - 4));
+
+	return frame.substr(FRAME_HEADER_SIZE - 4);
+}
+
+// клиент: держит до depth запросов в полёте и измеряет время от постановки запроса до получения ответа
+void Run(const string& address, size_t requests, size_t depth, const vector<double>& expected, Worker& worker) {
+	try {
+		int fd = OpenSocket(address, false);
+		vector<chrono::steady_clock::time_point> sent(requests);
+		string input;
+		char buffer[65536];
+		size_t next = 0;
+		size_t received = 0;
+
+		worker.latencies.reserve(requests);
+
+		while (received < requests) {
+			string output;
+
+			for (; next < requests && next - received < depth; next++) {
+				sent[next] = chrono::steady_clock::now();
+				output += EncodeEvaluate(next, FUNCTION_NAME, Argument(next));
+			}
+
+			SendAll(fd, output);
+
+			ssize_t size = recv(fd, buffer, sizeof(buffer), 0);
+
+			if (size <= 0)
+				throw string("connection closed by server");
+
+			input.append(buffer, size);
+
+			string frame;
+			chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+			while (ExtractFrame(input, frame)) {
+				uint32_t id = GetUint32(frame.data());
+
+				worker.latencies.push_back(chrono::duration<double, micro>(now - sent[id]).count());
+
+				if ((ResponseStatus) frame[4] != ResponseStatus::Ok)
+					worker.errors++;
+				else if (GetDouble(frame.data() + FRAME_HEADER_SIZE - 4) != expected[id % DISTINCT_ARGS])
+					worker.mismatches++;
+
+				received++;
+			}
+		}
+
+		close(fd);
+	}
+	catch (string error) {
+		worker.failure = error;
+	}
+}
+
+// значение перцентиля отсортированного массива
+double Percentile(const vector<double>& sorted, double p) {
+	return sorted[min(sorted.size() - 1, (size_t) (p / 100 * sorted.size()))];
+}
+
+int main(int argc, char **argv) {
+	if (argc > 5) {
+		cout << "Usage: " << argv[0] << " [socket path|port] [connections] [requests per connection] [pipeline depth]" << endl;
+		return -1;
+	}
+
+	string address = argc > 1 ? argv[1] : DEFAULT_ADDRESS;
+	size_t connections = argc > 2 ? stoul(argv[2]) : 4;
+	size_t requests = argc > 3 ? stoul(argv[3]) : 100000;
+	size_t depth = argc > 4 ? stoul(argv[4]) : 32;
+
+	if (connections == 0 || requests == 0 || depth == 0) {
+		cout << "error: connections, requests and pipeline depth must be positive" << endl;
+		return -1;
+	}
+
+	try {
+		// определяем функцию на сервере, она может остаться от прошлого запуска
+		try {
+			Command(address, FUNCTION_DEFINITION);
+		}
+		catch (string error) {
+			if (error.find("already exists") == string::npos)
+				throw;
+		}
+
+		// ожидаемые значения вычисляются локально тем же калькулятором
+		Calculator calculator(false);
+		vector<double> args(DISTINCT_ARGS);
+		vector<double> expected(DISTINCT_ARGS);
+
+		for (size_t i = 0; i < DISTINCT_ARGS; i++)
+			args[i] = Argument(i);
+
+		calculator.Calculate(FUNCTION_DEFINITION);
+		calculator.EvaluateBatch(FUNCTION_NAME, args.data(), expected.data(), DISTINCT_ARGS);
+
+		vector<Worker> workers(connections);
+		vector<thread> threads;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+		for (size_t i = 0; i < connections; i++)
+			threads.push_back(thread(Run, address, requests, depth, cref(expected), ref(workers[i])));
+
+		for (size_t i = 0; i < connections; i++)
+			threads[i].join();
+
+		double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		vector<double> latencies;
+		size_t errors = 0;
+		size_t mismatches = 0;
+
+		for (size_t i = 0; i < connections; i++) {
+			if (workers[i].failure != "")
+				throw workers[i].failure;
+
+			latencies.insert(latencies.end(), workers[i].latencies.begin(), workers[i].latencies.end());
+			errors += workers[i].errors;
+			mismatches += workers[i].mismatches;
+		}
+
+		sort(latencies.begin(), latencies.end());
+
+		cout << "Requests: " << latencies.size() << " over " << connections << " connections, pipeline depth " << depth << endl;
+		cout << "Errors: " << errors << ", mismatches: " << mismatches << endl;
+		cout << fixed << setprecision(1);
+		cout << "Throughput: " << latencies.size() / elapsed << " requests/s" << endl;
+		cout << "Latency, us: p50 " << Percentile(latencies, 50) << ", p90 " << Percentile(latencies, 90) << ", p99 " << Percentile(latencies, 99);
+		cout << ", p99.9 " << Percentile(latencies, 99.9) << ", max " << latencies.back() << endl;
+		cout << Command(address, "print server");
+	}
+	catch (string error) {
+		cout << "error: " << error << endl;
+		return -1;
+	}
+}
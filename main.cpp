@@ -5,8 +5,32 @@
 
 using namespace std;
 
-int main() {
+int main(int argc, char **argv) {
 	string mode;
+	Precision precision = Precision::Strict;
+	Arithmetic arithmetic = Arithmetic::Double;
+
+	// точность встроенных функций и арифметика задаются аргументами командной строки
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+
+		if (arg == "fast") {
+			precision = Precision::Fast;
+		}
+		else if (arg == "float") {
+			precision = Precision::Float;
+		}
+		else if (arg == "exact") {
+			arithmetic = Arithmetic::Exact;
+		}
+		else if (arg == "precise") {
+			arithmetic = Arithmetic::Precise;
+		}
+		else if (arg != "strict" && arg != "double") {
+			cout << "Usage: " << argv[0] << " [strict|fast|float] [double|exact|precise]" << endl;
+			return -1;
+		}
+	}
 
 	cout << "Welcome to CALCULATOR!" << endl;
 	cout << "Enter trigonometry mode (1 - degrees, [2] - radians): ";
@@ -20,7 +44,7 @@ int main() {
 	cout << "Type your commands after '>' and press 'Enter'" << endl;
 	cout << "Use 'help' command for usage" << endl;
 
-	Calculator calculator(mode == "1");
+	Calculator calculator(mode == "1", precision, arithmetic);
 
 	do {
 		string command; // строка для считывания команды
@@ -39,6 +63,12 @@ int main() {
 			continue;
 		}
 
+		// если команда вывода точности встроенных функций
+		if (command == "print accuracy") {
+			calculator.PrintAccuracy(); // выводим ошибку функций
+			continue;
+		}
+
 		// если команда сброса состояния калькулятора
 		if (command == "reset") {
 			calculator.Reset(); // сбрасываем состояние калькулятора
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <string>
+
+#include "Server.hpp"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+	string address = DEFAULT_ADDRESS;
+	bool degrees = false;
+	Precision precision = Precision::Strict;
+	Arithmetic arithmetic = Arithmetic::Double;
+
+	// адрес (порт или путь к сокету), режим тригонометрии, точность функций и арифметика задаются аргументами командной строки
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+
+		if (arg == "degrees") {
+			degrees = true;
+		}
+		else if (arg == "fast") {
+			precision = Precision::Fast;
+		}
+		else if (arg == "float") {
+			precision = Precision::Float;
+		}
+		else if (arg == "exact") {
+			arithmetic = Arithmetic::Exact;
+		}
+		else if (arg == "precise") {
+			arithmetic = Arithmetic::Precise;
+		}
+		else if (arg == "strict" || arg == "double" || arg == "radians") {
+			continue;
+		}
+		else if (arg[0] == '-') {
+			cout << "Usage: " << argv[0] << " [socket path|port] [radians|degrees] [strict|fast|float] [double|exact|precise]" << endl;
+			return -1;
+		}
+		else {
+			address = arg;
+		}
+	}
+
+	try {
+		Calculator calculator(degrees, precision, arithmetic);
+		Server server(calculator, address);
+
+		cout << "Listening on " << address << endl;
+		server.Run();
+	}
+	catch (string error) {
+		cout << "error: " << error << endl;
+		return -1;
+	}
+}